@@ -0,0 +1,86 @@
+// Times SDL_Plotter's blend spans against the opaque plotSpan fill over
+// a full screen: alpha 255 should cost the same as the opaque path, and
+// translucent spans run through the SSE2 loops where available. The
+// short runs, as text is drawn, show what blendRun saves by leaving the
+// color and alpha checks to the caller.
+//
+//     make bench && ./build/bench/BlendBench
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Constants.h"
+#include "SDL_Plotter.h"
+
+namespace {
+
+const int ITERATIONS = 200;
+
+// Width of the short runs, about one scaled glyph column
+const int SHORT_RUN = 2;
+
+template <typename Draw>
+double microsPerScreen(Draw draw) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        for (int y = 0; y < SCREEN_HEIGHT; y++) {
+            draw(y);
+        }
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / ITERATIONS;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+
+    SDL_Plotter plotter(SCREEN_HEIGHT, SCREEN_WIDTH, false);
+
+    std::vector<Uint32> source(SCREEN_WIDTH);
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+        source[x] = (Uint32)(x * 255 / SCREEN_WIDTH) << 24 | 0x00FF8040;
+    }
+
+    double opaque = microsPerScreen([&](int y) {
+        plotter.plotSpan(0, SCREEN_WIDTH - 1, y, 40, 50, 70);
+    });
+    double alpha255 = microsPerScreen([&](int y) {
+        plotter.blendSpan(0, SCREEN_WIDTH - 1, y, 40, 50, 70, 255);
+    });
+    double alpha128 = microsPerScreen([&](int y) {
+        plotter.blendSpan(0, SCREEN_WIDTH - 1, y, 40, 50, 70, 128);
+    });
+    double perPixel = microsPerScreen([&](int y) {
+        plotter.blendSpan(0, y, &source[0], SCREEN_WIDTH);
+    });
+    double shortSpan = microsPerScreen([&](int y) {
+        for (int x = 0; x + SHORT_RUN <= SCREEN_WIDTH; x += SHORT_RUN) {
+            plotter.blendSpan<ClipMode::Unclipped>(x, x + SHORT_RUN - 1, y, 40, 50, 70, 128);
+        }
+    });
+    double shortRun = microsPerScreen([&](int y) {
+        Uint32 color = packColor(40, 50, 70);
+        for (int x = 0; x + SHORT_RUN <= SCREEN_WIDTH; x += SHORT_RUN) {
+            plotter.blendRun<ClipMode::Unclipped, BlendMode::Alpha>(x, x + SHORT_RUN - 1, y, color, 128);
+        }
+    });
+    double scalar = microsPerScreen([&](int y) {
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            plotter.blendPixel(x, y, 40, 50, 70, 128);
+        }
+    });
+
+    std::printf("%-28s %10s\n", "full screen", "us");
+    std::printf("%-28s %10.1f\n", "plotSpan (opaque)", opaque);
+    std::printf("%-28s %10.1f\n", "blendSpan alpha 255", alpha255);
+    std::printf("%-28s %10.1f\n", "blendSpan alpha 128", alpha128);
+    std::printf("%-28s %10.1f\n", "blendSpan per-pixel alpha", perPixel);
+    std::printf("%-28s %10.1f\n", "blendSpan 2 px runs", shortSpan);
+    std::printf("%-28s %10.1f\n", "blendRun 2 px runs", shortRun);
+    std::printf("%-28s %10.1f\n", "blendPixel alpha 128", scalar);
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Times Renderer::drawCircle against the old per-pixel bounding-square
+// test for radii 3-64, plus the anti-aliased variant.
+//
+// Runs against SDL's dummy video driver so no window is needed:
+//     make bench && ./build/bench/CircleBench
+
+#include <chrono>
+#include <cstdio>
+
+#include "Constants.h"
+#include "Renderer.h"
+#include "SDL_Plotter.h"
+
+namespace {
+
+const int ITERATIONS = 2000;
+
+// The drawCircle loop as it was before the scanline rewrite, kept here
+// as the baseline.
+void bruteForceCircle(SDL_Plotter& plotter, int cx, int cy, int radius, int r, int g, int b) {
+    for (int y = -radius; y <= radius; y++) {
+        for (int x = -radius; x <= radius; x++) {
+            if (x * x + y * y <= radius * radius) {
+                int px = cx + x;
+                int py = cy + y;
+                if (px >= 0 && px < SCREEN_WIDTH && py >= 0 && py < SCREEN_HEIGHT) {
+                    plotter.plotPixel(px, py, r, g, b);
+                }
+            }
+        }
+    }
+}
+
+template <typename Draw>
+double nanosPerCircle(Draw draw) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        draw(i);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+
+    SDL_Plotter plotter(SCREEN_HEIGHT, SCREEN_WIDTH, false);
+    Renderer renderer(plotter, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    const int radii[] = {3, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+
+    std::printf("%6s %14s %14s %14s %9s\n", "radius", "brute ns", "scanline ns", "aa ns", "speedup");
+    for (int radius : radii) {
+        // Jitter the centre so the circle is sometimes clipped at the edge.
+        double brute = nanosPerCircle([&](int i) {
+            bruteForceCircle(plotter, (i * 37) % SCREEN_WIDTH, (i * 53) % SCREEN_HEIGHT, radius, 255, 215, 0);
+        });
+        double scanline = nanosPerCircle([&](int i) {
+            renderer.drawCircle((i * 37) % SCREEN_WIDTH, (i * 53) % SCREEN_HEIGHT, radius, 255, 215, 0);
+        });
+        double aa = nanosPerCircle([&](int i) {
+            renderer.drawCircleAA((i * 37) % SCREEN_WIDTH, (i * 53) % SCREEN_HEIGHT, radius, 255, 215, 0);
+        });
+        std::printf("%6d %14.1f %14.1f %14.1f %8.2fx\n", radius, brute, scanline, aa, brute / scanline);
+    }
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Times each Renderer primitive in its Clipped and Unclipped
+// instantiations, drawn fully on screen (where the draw functions pick
+// Unclipped), to show what skipping the bounds tests saves. The last
+// shapes hang off the screen into a guard band, where Unclipped also
+// draws the hidden part. Far off, as buildings and trains get, that costs
+// more than clipping it away, which is why the game's guard band
+// (FRAME_GUARD) only covers small overhangs.
+//
+//     make bench && ./build/bench/ClipBench
+
+#include <chrono>
+#include <cstdio>
+
+#include "Constants.h"
+#include "Renderer.h"
+#include "SDL_Plotter.h"
+
+namespace {
+
+const int ITERATIONS = 20000;
+
+// Enough for a building scrolled 100 px off the left edge and a train
+// entering 60 px above the top
+const int GUARD_X = 112;
+const int GUARD_Y = 64;
+
+template <typename Draw>
+double nanosPerDraw(Draw draw) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        draw(i);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+void report(const char* name, double clipped, double unclipped) {
+    std::printf("%-28s %12.1f %12.1f %8.2fx\n", name, clipped, unclipped, clipped / unclipped);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+
+    SDL_Plotter plotter(SCREEN_HEIGHT, SCREEN_WIDTH, false, PresentMode::Accelerated, GUARD_X, GUARD_Y);
+    Renderer renderer(plotter, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    // Positions move a little each iteration but stay where they start:
+    // on screen, or for the building and the train partly in the guard band
+    std::printf("%-28s %12s %12s %9s\n", "primitive", "clipped ns", "unclipped ns", "speedup");
+
+    report("HUD box 200x60 alpha",
+           nanosPerDraw([&](int i) {
+               renderer.fillBox<ClipMode::Clipped, BlendMode::Alpha>(10 + i % 8, 10, 200, 60, 30, 40, 60, 210);
+           }),
+           nanosPerDraw([&](int i) {
+               renderer.fillBox<ClipMode::Unclipped, BlendMode::Alpha>(10 + i % 8, 10, 200, 60, 30, 40, 60, 210);
+           }));
+
+    report("player body 40x50 gradient",
+           nanosPerDraw([&](int i) {
+               renderer.fillGradient<ClipMode::Clipped, BlendMode::Opaque>(250 + i % 8, 450, PLAYER_WIDTH,
+                                                                           PLAYER_HEIGHT, 0, 220, 255, 0, 150,
+                                                                           200, 255);
+           }),
+           nanosPerDraw([&](int i) {
+               renderer.fillGradient<ClipMode::Unclipped, BlendMode::Opaque>(250 + i % 8, 450, PLAYER_WIDTH,
+                                                                             PLAYER_HEIGHT, 0, 220, 255, 0, 150,
+                                                                             200, 255);
+           }));
+
+    report("text scale 2",
+           nanosPerDraw([&](int i) {
+               renderer.drawString<ClipMode::Clipped, BlendMode::Opaque>(20 + i % 8, 35, "SCORE 123456", 255,
+                                                                         255, 150, 2, 255);
+           }),
+           nanosPerDraw([&](int i) {
+               renderer.drawString<ClipMode::Unclipped, BlendMode::Opaque>(20 + i % 8, 35, "SCORE 123456", 255,
+                                                                           255, 150, 2, 255);
+           }));
+
+    report("text scale 1 alpha",
+           nanosPerDraw([&](int i) {
+               renderer.drawString<ClipMode::Clipped, BlendMode::Alpha>(20 + i % 8, 185, "A/LEFT - MOVE LEFT",
+                                                                        205, 150, 200, 1, 128);
+           }),
+           nanosPerDraw([&](int i) {
+               renderer.drawString<ClipMode::Unclipped, BlendMode::Alpha>(20 + i % 8, 185, "A/LEFT - MOVE LEFT",
+                                                                          205, 150, 200, 1, 128);
+           }));
+
+    report("circle r=3 (eye)",
+           nanosPerDraw([&](int i) { renderer.fillCircle<ClipMode::Clipped>(262 + i % 8, 435, 3, 0, 0, 0); }),
+           nanosPerDraw([&](int i) { renderer.fillCircle<ClipMode::Unclipped>(262 + i % 8, 435, 3, 0, 0, 0); }));
+
+    report("circle r=15 (coin)",
+           nanosPerDraw([&](int i) { renderer.fillCircle<ClipMode::Clipped>(500 + i % 8, 300, 15, 255, 215, 0); }),
+           nanosPerDraw([&](int i) {
+               renderer.fillCircle<ClipMode::Unclipped>(500 + i % 8, 300, 15, 255, 215, 0);
+           }));
+
+    report("AA circle r=18 (head)",
+           nanosPerDraw([&](int i) {
+               renderer.fillCircleAA<ClipMode::Clipped>(270 + i % 8, 435, 18, 255, 180, 100);
+           }),
+           nanosPerDraw([&](int i) {
+               renderer.fillCircleAA<ClipMode::Unclipped>(270 + i % 8, 435, 18, 255, 180, 100);
+           }));
+
+    // Partly off screen, but inside the guard band
+    report("building off left edge",
+           nanosPerDraw([&](int i) {
+               renderer.fillGradient<ClipMode::Clipped, BlendMode::Opaque>(-100 + i % 8, 70, 140, 180, 45, 55, 75,
+                                                                           35, 45, 65, 255);
+           }),
+           nanosPerDraw([&](int i) {
+               renderer.fillGradient<ClipMode::Unclipped, BlendMode::Opaque>(-100 + i % 8, 70, 140, 180, 45, 55, 75,
+                                                                             35, 45, 65, 255);
+           }));
+
+    report("train entering at top",
+           nanosPerDraw([&](int i) {
+               renderer.fillGradient<ClipMode::Clipped, BlendMode::Opaque>(475, -60 + i % 8, 180, 80, 80, 180, 220,
+                                                                           40, 120, 180, 255);
+           }),
+           nanosPerDraw([&](int i) {
+               renderer.fillGradient<ClipMode::Unclipped, BlendMode::Opaque>(475, -60 + i % 8, 180, 80, 80, 180, 220,
+                                                                             40, 120, 180, 255);
+           }));
+
+    // Hanging a few pixels off screen, inside the game's guard band
+    report("coin entering at top",
+           nanosPerDraw([&](int i) { renderer.fillCircle<ClipMode::Clipped>(500, 4 + i % 8, 15, 255, 215, 0); }),
+           nanosPerDraw([&](int i) { renderer.fillCircle<ClipMode::Unclipped>(500, 4 + i % 8, 15, 255, 215, 0); }));
+
+    report("window off left edge",
+           nanosPerDraw([&](int i) {
+               renderer.fillGradient<ClipMode::Clipped, BlendMode::Opaque>(-10 + i % 8, 80, 12, 15, 255, 255, 100,
+                                                                           205, 205, 50, 255);
+           }),
+           nanosPerDraw([&](int i) {
+               renderer.fillGradient<ClipMode::Unclipped, BlendMode::Opaque>(-10 + i % 8, 80, 12, 15, 255, 255, 100,
+                                                                             205, 205, 50, 255);
+           }));
+
+    report("particle off bottom edge",
+           nanosPerDraw([&](int i) {
+               renderer.fillBox<ClipMode::Clipped, BlendMode::Alpha>(300 + i % 8, SCREEN_HEIGHT - 3, 6, 6, 255, 100,
+                                                                     100, 128);
+           }),
+           nanosPerDraw([&](int i) {
+               renderer.fillBox<ClipMode::Unclipped, BlendMode::Alpha>(300 + i % 8, SCREEN_HEIGHT - 3, 6, 6, 255,
+                                                                       100, 100, 128);
+           }));
+
+    // One lane rail: three one-pixel spans per row down the track
+    report("lane rail (350 rows)",
+           nanosPerDraw([&](int i) {
+               int lx = LANE_POSITIONS[i % NUM_LANES];
+               for (int y = HORIZON_Y; y < SCREEN_HEIGHT; y++) {
+                   plotter.plotSpan<ClipMode::Clipped>(lx - 1, lx - 1, y, 150, 150, 70);
+                   plotter.plotSpan<ClipMode::Clipped>(lx, lx, y, 220, 220, 120);
+                   plotter.plotSpan<ClipMode::Clipped>(lx + 1, lx + 1, y, 150, 150, 70);
+               }
+           }),
+           nanosPerDraw([&](int i) {
+               int lx = LANE_POSITIONS[i % NUM_LANES];
+               for (int y = HORIZON_Y; y < SCREEN_HEIGHT; y++) {
+                   plotter.plotSpan<ClipMode::Unclipped>(lx - 1, lx - 1, y, 150, 150, 70);
+                   plotter.plotSpan<ClipMode::Unclipped>(lx, lx, y, 220, 220, 120);
+                   plotter.plotSpan<ClipMode::Unclipped>(lx + 1, lx + 1, y, 150, 150, 70);
+               }
+           }));
+
+    return 0;
+}
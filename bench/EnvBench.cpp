@@ -0,0 +1,85 @@
+// Steps batches of games through the libsubway C API with a simple
+// dodging policy, and times the optional downsampled framebuffer.
+//
+//     make bench && ./build/bench/EnvBench
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "SubwayEnv.h"
+
+namespace {
+
+const int STEPS = 2000;
+const int RENDER_FRAMES = 200;
+const int RENDER_FACTOR = 4;
+
+// Leaves the lane when an obstacle gets close, for the lane with the
+// most room; a finished run is reset with the next seed
+int dodge(const SubwayObservation& o) {
+    int lane = (int)o.lane;
+    if (o.obstacleDistance[lane] > 120) return SUBWAY_ACTION_NONE;
+    int best = lane;
+    for (int l = lane - 1; l <= lane + 1; l++) {
+        if (l >= 0 && l < SUBWAY_LANES && o.obstacleDistance[l] > o.obstacleDistance[best]) best = l;
+    }
+    if (best < lane) return SUBWAY_ACTION_LEFT;
+    if (best > lane) return SUBWAY_ACTION_RIGHT;
+    return SUBWAY_ACTION_NONE;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::printf("%-12s %14s %12s\n", "instances", "steps/s", "runs ended");
+    for (int instances : {1, 16, 256, 4096}) {
+        SubwayEnv* env = subway_create(instances, nullptr, 0);
+        if (env == nullptr) return 1;
+        subway_reset(env, -1, 1);
+        const SubwayObservation* observations = subway_observations(env);
+
+        std::vector<int32_t> actions(instances);
+        std::vector<float> rewards(instances);
+        std::vector<uint8_t> dones(instances);
+        unsigned seed = instances + 1;
+        int ended = 0;
+
+        // The policy and the resets count against the rate, as they
+        // would for an agent
+        int steps = STEPS * 256 / instances + 1;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int step = 0; step < steps; step++) {
+            for (int i = 0; i < instances; i++) {
+                actions[i] = dodge(observations[i]);
+            }
+            subway_step(env, actions.data(), rewards.data(), dones.data());
+            for (int i = 0; i < instances; i++) {
+                if (dones[i]) {
+                    subway_reset(env, i, seed++);
+                    ended++;
+                }
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-12d %14.0f %12d\n", instances, (double)steps * instances / seconds, ended);
+        subway_destroy(env);
+    }
+
+    SubwayEnv* env = subway_create(1, nullptr, SUBWAY_RENDER);
+    if (env == nullptr) return 1;
+    subway_reset(env, 0, 1);
+    int width, height;
+    subway_frame_size(RENDER_FACTOR, &width, &height);
+    std::vector<uint32_t> pixels(width * height);
+    int32_t action = SUBWAY_ACTION_NONE;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < RENDER_FRAMES; frame++) {
+        subway_step(env, &action, nullptr, nullptr);
+        subway_render(env, 0, RENDER_FACTOR, pixels.data());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("\nstep + render %dx%d: %.1f us per frame\n", width, height, seconds * 1e6 / RENDER_FRAMES);
+    subway_destroy(env);
+    return 0;
+}
@@ -0,0 +1,55 @@
+// Steps the same scripted games on float and on 16.16 fixed-point
+// physics, and prints a hash of where each ends up. The fixed-point hash
+// is the same from any compiler, optimization level, -march or
+// -ffast-math; the float one need not be.
+//
+//     make bench && ./build/bench/PhysicsBench
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "Config.h"
+#include "GameState.h"
+
+namespace {
+
+const int GAMES = 8;
+const int TICKS = 20000;
+
+// Plays GAMES seeds for TICKS ticks each with a fixed pattern of lane
+// changes and jumps, restarting after a game over
+template <class Scalar>
+void run(const char* name, const GameConfig& config) {
+    static BasicGameState<Scalar> state;
+    // Each game's final state hash, folded in turn
+    uint64_t hash = 14695981039346656037ull;
+    long long ticks = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int game = 0; game < GAMES; game++) {
+        state.reset(config, game + 1);
+        state.applyKey(config, ' ');
+        for (int t = 0; t < TICKS; t++) {
+            if (state.gameState == STATE_GAME_OVER) state.applyKey(config, 'r');
+            if (t % 23 == 0) state.applyKey(config, (t / 23) % 3 == 0 ? 'a' : 'd');
+            if (t % 41 == 0) state.applyKey(config, 'w');
+            state.step(config);
+            ticks++;
+        }
+        hash = (hash ^ state.hash().combined()) * 1099511628211ull;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-8s %12.0f %10.1f   %016llx\n", name, ticks / seconds, seconds * 1e9 / ticks,
+                (unsigned long long)hash);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    GameConfig config;
+    std::printf("%d games x %d ticks, particles kept\n\n", GAMES, TICKS);
+    std::printf("%-8s %12s %10s %18s\n", "physics", "ticks/s", "ns/tick", "state hash");
+    run<float>("float", config);
+    run<Fixed>("fixed", config);
+    return 0;
+}
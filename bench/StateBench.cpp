@@ -0,0 +1,57 @@
+// Times snapshotting and restoring the whole GameState, the way rewind
+// and lookahead use it, and hashing it, the way replays check each tick,
+// against one simulation tick for scale.
+//
+//     make bench && ./build/bench/StateBench
+
+#include <chrono>
+#include <cstdio>
+
+#include "Config.h"
+#include "GameState.h"
+
+namespace {
+
+const int ITERATIONS = 200000;
+const int WARMUP_TICKS = 600;
+
+template <typename Op>
+double nanosPerOp(Op op) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        op(i);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    GameConfig config;
+    GameState live;
+    live.reset(config, 1);
+    live.applyKey(config, ' ');
+
+    // Play a while, jumping now and then, so particles are in flight
+    for (int i = 0; i < WARMUP_TICKS && live.gameState == STATE_PLAYING; i++) {
+        if (i % 40 == 0) live.applyKey(config, ' ');
+        live.step(config);
+    }
+
+    static GameState copies[2];
+    std::printf("GameState %zu bytes, %d live particles\n\n", sizeof(GameState), live.particleCount);
+    std::printf("%-28s %12s\n", "operation", "ns");
+
+    std::printf("%-28s %12.1f\n", "snapshot (copyTo)", nanosPerOp([&](int i) { live.copyTo(copies[i & 1]); }));
+    std::printf("%-28s %12.1f\n", "snapshot (assignment)", nanosPerOp([&](int i) { copies[i & 1] = live; }));
+    uint64_t hashes = 0;
+    std::printf("%-28s %12.1f\n", "hash", nanosPerOp([&](int i) { hashes += live.hash().fields[i % STATE_FIELD_COUNT]; }));
+    std::printf("%-28s %12.1f\n", "restore + step", nanosPerOp([&](int i) {
+                    copies[0].copyTo(copies[1]);
+                    copies[1].step(config);
+                }));
+
+    // Keeps the copies from being optimized away
+    return copies[1].score == -1 && hashes == 0;
+}
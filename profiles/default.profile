@@ -0,0 +1,18 @@
+# Gameplay profile. Load with: ./Game_Executable --profile profiles/default.profile
+# Every key is optional; missing keys keep the built-in defaults shown here.
+
+# Physics, in pixels per tick (60 ticks per second)
+gravity = 0.6
+jump_velocity = -12.0
+base_scroll_speed = 3.0
+level_speed_step = 0.5
+
+# Spawn densities: one in N
+obstacle_spawn_chance = 3
+collectible_spawn_chance = 2
+heart_spawn_chance = 10
+heart_respawn_chance = 15
+
+# Audio device buffer in sample frames (power of two). Smaller starts
+# sound effects sooner; raise it if the audio crackles.
+audio_buffer_size = 1024
@@ -0,0 +1,7 @@
+# Faster track, denser obstacles, rarer hearts.
+
+base_scroll_speed = 5.0
+level_speed_step = 0.75
+obstacle_spawn_chance = 2
+heart_spawn_chance = 20
+heart_respawn_chance = 30
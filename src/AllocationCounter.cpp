@@ -0,0 +1,184 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+const char* subsystemName(Subsystem subsystem) {
+    switch (subsystem) {
+        case Subsystem::Game:
+            return "game";
+        case Subsystem::Renderer:
+            return "renderer";
+        case Subsystem::Plotter:
+            return "plotter";
+        case Subsystem::Audio:
+            return "audio";
+        default:
+            return "other";
+    }
+}
+
+#ifdef SUBWAY_COUNT_ALLOCATIONS
+
+// Relaxed atomics: the music loader thread allocates too, and only the
+// totals matter
+static std::atomic<unsigned long long> allocations[SUBSYSTEM_COUNT];
+static std::atomic<unsigned long long> allocatedBytes[SUBSYSTEM_COUNT];
+
+// Constant-initialized, so it is safe to read from operator new at any
+// point in a thread's life
+static thread_local Subsystem currentSubsystem = Subsystem::Other;
+
+static void* countedAllocate(std::size_t size) {
+    int s = static_cast<int>(currentSubsystem);
+    allocations[s].fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes[s].fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+static void* countedAllocate(std::size_t size, std::align_val_t alignment) {
+    int s = static_cast<int>(currentSubsystem);
+    allocations[s].fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes[s].fetch_add(size, std::memory_order_relaxed);
+    // aligned_alloc wants a whole number of alignments
+    std::size_t a = static_cast<std::size_t>(alignment);
+    std::size_t rounded = size == 0 ? a : (size + a - 1) / a * a;
+    return std::aligned_alloc(a, rounded);
+}
+
+void* operator new(std::size_t size) {
+    void* p = countedAllocate(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    void* p = countedAllocate(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* p = countedAllocate(size, alignment);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    void* p = countedAllocate(size, alignment);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAllocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAllocate(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+// aligned_alloc memory is released with free like the rest
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+AllocationScope::AllocationScope(Subsystem subsystem) : previous(currentSubsystem) {
+    currentSubsystem = subsystem;
+}
+
+AllocationScope::~AllocationScope() {
+    currentSubsystem = previous;
+}
+
+bool allocationCountingEnabled() {
+    return true;
+}
+
+AllocationCount allocationCount(Subsystem subsystem) {
+    int s = static_cast<int>(subsystem);
+    AllocationCount c;
+    c.count = allocations[s].load(std::memory_order_relaxed);
+    c.bytes = allocatedBytes[s].load(std::memory_order_relaxed);
+    return c;
+}
+
+#else
+
+bool allocationCountingEnabled() {
+    return false;
+}
+
+AllocationCount allocationCount(Subsystem) {
+    AllocationCount c;
+    c.count = 0;
+    c.bytes = 0;
+    return c;
+}
+
+#endif
+
+AllocationCount allocationCount() {
+    AllocationCount total;
+    total.count = 0;
+    total.bytes = 0;
+    for (int s = 0; s < SUBSYSTEM_COUNT; s++) {
+        AllocationCount c = allocationCount(static_cast<Subsystem>(s));
+        total.count += c.count;
+        total.bytes += c.bytes;
+    }
+    return total;
+}
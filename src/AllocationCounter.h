@@ -0,0 +1,64 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+// Counts calls to the global allocator. Builds made with
+// SUBWAY_COUNT_ALLOCATIONS defined replace operator new and delete with
+// counting versions; other builds leave the allocator alone and report
+// zero.
+struct AllocationCount {
+    unsigned long long count;
+    unsigned long long bytes;
+};
+
+// Who an allocation is charged to: the innermost AllocationScope alive on
+// the allocating thread, or Other outside of any scope
+enum class Subsystem { Game, Renderer, Plotter, Audio, Other };
+const int SUBSYSTEM_COUNT = 5;
+
+// description: names a subsystem for reports
+// return: const char* (lower case)
+// precondition: none
+// postcondition: none
+const char* subsystemName(Subsystem subsystem);
+
+// description: reports whether the counting allocator is compiled in
+// return: bool
+// precondition: none
+// postcondition: none
+bool allocationCountingEnabled();
+
+// description: reads the running totals
+// return: AllocationCount (allocations and bytes since startup)
+// precondition: none
+// postcondition: none
+AllocationCount allocationCount();
+
+// description: reads the running totals charged to one subsystem
+// return: AllocationCount (allocations and bytes since startup)
+// precondition: none
+// postcondition: none
+AllocationCount allocationCount(Subsystem subsystem);
+
+// Charges the allocations this thread makes while the scope is alive to a
+// subsystem. Scopes nest; the previous subsystem is restored on exit.
+// Without SUBWAY_COUNT_ALLOCATIONS it does nothing.
+class AllocationScope {
+#ifdef SUBWAY_COUNT_ALLOCATIONS
+   private:
+    Subsystem previous;
+
+   public:
+    explicit AllocationScope(Subsystem subsystem);
+    ~AllocationScope();
+#else
+   public:
+    explicit AllocationScope(Subsystem) {}
+#endif
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "AssetArchive.h"
+
+#include <string.h>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#if defined(_WIN32)
+#define ASSETS_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetArchive::AssetArchive() : data(nullptr), size(0), entries(nullptr), count(0) {}
+
+AssetArchive::~AssetArchive() {
+    close();
+}
+
+void AssetArchive::close() {
+#if !defined(ASSETS_NO_MMAP)
+    if (data != nullptr && fallback.empty()) {
+        munmap((void*)data, size);
+    }
+#endif
+    std::vector<unsigned char>().swap(fallback);
+    data = nullptr;
+    size = 0;
+    entries = nullptr;
+    count = 0;
+}
+
+bool AssetArchive::open(const std::string& path) {
+    close();
+
+#if defined(ASSETS_NO_MMAP)
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) return false;
+    fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (fallback.empty()) return false;
+    data = &fallback[0];
+    size = fallback.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    data = (const unsigned char*)mapped;
+    size = (size_t)info.st_size;
+#endif
+
+    if (!validate()) {
+        std::cout << "Ignoring invalid asset archive: " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetArchive::validate() {
+    if (size < sizeof(PakHeader)) return false;
+
+    const PakHeader* header = (const PakHeader*)data;
+    if (memcmp(header->magic, PAK_MAGIC, sizeof(PAK_MAGIC)) != 0 || header->version != PAK_VERSION) {
+        return false;
+    }
+    if (header->count > (size - sizeof(PakHeader)) / sizeof(PakEntry)) return false;
+
+    const PakEntry* index = (const PakEntry*)(data + sizeof(PakHeader));
+    for (uint32_t i = 0; i < header->count; i++) {
+        if (index[i].name[PAK_NAME_LENGTH - 1] != '\0') return false;
+        if (index[i].offset > size || index[i].size > size - index[i].offset) return false;
+        // find() binary-searches, so names must be sorted and unique
+        if (i > 0 && strncmp(index[i - 1].name, index[i].name, PAK_NAME_LENGTH) >= 0) return false;
+    }
+
+    entries = index;
+    count = header->count;
+    return true;
+}
+
+bool AssetArchive::isOpen() const {
+    return data != nullptr;
+}
+
+bool AssetArchive::find(const std::string& name, const void*& bytes, size_t& length) const {
+    // The index is sorted by name
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int order = strncmp(entries[mid].name, name.c_str(), PAK_NAME_LENGTH);
+        if (order == 0) {
+            bytes = data + entries[mid].offset;
+            length = entries[mid].size;
+            return true;
+        }
+        if (order < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return false;
+}
+
+SDL_RWops* AssetArchive::openAsset(const std::string& name) const {
+    const void* bytes = nullptr;
+    size_t length = 0;
+    if (isOpen() && find(name, bytes, length)) {
+        return SDL_RWFromConstMem(bytes, (int)length);
+    }
+    return SDL_RWFromFile(pathNextToExecutable("assets/" + name).c_str(), "rb");
+}
+
+std::string pathNextToExecutable(const std::string& file) {
+    char* base = SDL_GetBasePath();
+    if (base == nullptr) return file;
+
+    std::string path = std::string(base) + file;
+    SDL_free(base);
+    return path;
+}
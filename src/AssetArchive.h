@@ -0,0 +1,83 @@
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+
+#include <SDL2/SDL.h>
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "AssetFormat.h"
+
+// Read-only view of a packed asset archive (see AssetFormat.h). The file
+// is memory-mapped, and assets are handed out as pointers into the
+// mapping, so decoders read straight from it without a copy.
+class AssetArchive {
+   private:
+    const unsigned char* data;
+    size_t size;
+    const PakEntry* entries;
+    uint32_t count;
+    std::vector<unsigned char> fallback;  // file contents where mmap is unavailable
+
+    // description: checks the header and index of the mapped file
+    // return: bool, true if every entry lies inside the file and the
+    //         names are sorted with no repeats
+    // precondition: data and size set
+    // postcondition: entries and count set if true
+    bool validate();
+
+    // description: unmaps the file
+    // return: void
+    // precondition: none
+    // postcondition: archive empty
+    void close();
+
+   public:
+    // description: makes an archive with nothing mapped
+    // return: N/A (constructor)
+    // precondition: none
+    // postcondition: isOpen() false
+    AssetArchive();
+
+    // description: unmaps the archive
+    // return: N/A (destructor)
+    // precondition: nothing still reads from the archive's memory
+    // postcondition: file unmapped
+    ~AssetArchive();
+
+    // description: maps an archive file
+    // return: bool, true if the file was mapped and is a valid archive
+    // precondition: none
+    // postcondition: previous archive, if any, closed
+    bool open(const std::string& path);
+
+    // description: check an archive is mapped
+    // return: bool
+    // precondition: none
+    // postcondition: none
+    bool isOpen() const;
+
+    // description: looks up an asset by its path under assets/
+    // return: bool, true if the asset is in the archive
+    // precondition: archive open
+    // postcondition: bytes and length point into the mapping if true
+    bool find(const std::string& name, const void*& bytes, size_t& length) const;
+
+    // description: opens an asset for reading by SDL / SDL_mixer; from
+    //              the archive if it is there, else the loose file
+    //              assets/<name> next to the executable
+    // return: SDL_RWops*, or nullptr if neither exists
+    // precondition: archive outlives the returned stream
+    // postcondition: caller owns the stream (pass freesrc = 1 to loaders)
+    SDL_RWops* openAsset(const std::string& name) const;
+};
+
+// description: path of a file in the executable's directory
+// return: string path, or file itself if SDL cannot tell
+// precondition: none
+// postcondition: none
+std::string pathNextToExecutable(const std::string& file);
+
+#endif
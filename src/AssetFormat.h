@@ -0,0 +1,32 @@
+#ifndef ASSETFORMAT_H
+#define ASSETFORMAT_H
+
+#include <stdint.h>
+
+// Layout of assets.pak, shared by the AssetPacker tool and AssetArchive.
+//
+//   PakHeader
+//   PakEntry[count]   sorted by name, so lookups can binary search
+//   asset data        each blob starts on a PAK_ALIGNMENT boundary
+//
+// All integers are little-endian.
+
+const char PAK_MAGIC[4] = {'S', 'S', 'P', 'K'};
+const uint32_t PAK_VERSION = 1;
+const uint32_t PAK_ALIGNMENT = 16;
+const int PAK_NAME_LENGTH = 56;
+
+struct PakHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct PakEntry {
+    char name[PAK_NAME_LENGTH];  // path under assets/, NUL-padded
+    uint32_t offset;             // from the start of the file
+    uint32_t size;
+};
+
+#endif
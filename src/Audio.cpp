@@ -0,0 +1,239 @@
+#include "Audio.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "AllocationCounter.h"
+
+AudioContext::AudioContext()
+    : opened(false), music(nullptr), musicStarted(false), musicLoaded(false), loadedMusic(nullptr) {}
+
+bool AudioContext::open(int bufferSize) {
+    if (opened) return true;
+
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        std::cout << "SDL audio Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    if (Mix_OpenAudio(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, 2, bufferSize) < 0) {
+        std::cout << "SDL_mixer Error: " << Mix_GetError() << std::endl;
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+    opened = true;
+    return true;
+}
+
+AudioContext::~AudioContext() {
+    if (loader.joinable()) {
+        loader.join();
+    }
+    if (music == nullptr) {
+        music = loadedMusic;
+    }
+    if (music != nullptr) {
+        Mix_HaltMusic();
+        Mix_FreeMusic(music);
+    }
+    if (opened) {
+        Mix_CloseAudio();
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+}
+
+bool AudioContext::isOpen() const {
+    return opened;
+}
+
+void AudioContext::loadMusicAsync(SDL_RWops* source) {
+    if (!opened || loader.joinable()) {
+        if (source != nullptr) SDL_RWclose(source);
+        return;
+    }
+    loader = std::thread(&AudioContext::loadMusic, this, source);
+}
+
+void AudioContext::loadMusic(SDL_RWops* source) {
+    AllocationScope scope(Subsystem::Audio);
+    Mix_Music* loaded = source != nullptr ? Mix_LoadMUS_RW(source, 1) : nullptr;
+    if (loaded == nullptr) {
+        std::cout << "Failed to load music: " << Mix_GetError() << std::endl;
+    }
+    loadedMusic = loaded;
+    musicLoaded.store(true, std::memory_order_release);
+
+    // Wake a main loop idling in SDL_WaitEventTimeout so the music starts
+    // now rather than at the next input
+    SDL_Event wake;
+    SDL_memset(&wake, 0, sizeof(wake));
+    wake.type = SDL_USEREVENT;
+    SDL_PushEvent(&wake);
+}
+
+bool AudioContext::update() {
+    if (musicStarted || !musicLoaded.load(std::memory_order_acquire)) return false;
+
+    AllocationScope scope(Subsystem::Audio);
+    loader.join();
+    musicStarted = true;
+    music = loadedMusic;
+    loadedMusic = nullptr;
+    if (music != nullptr) {
+        Mix_PlayMusic(music, -1);
+        Mix_VolumeMusic(64);
+    }
+    return true;
+}
+
+SoundBank::SoundBank() : count(0) {
+    for (int i = 0; i < MAX_SOUNDS; i++) {
+        chunks[i] = nullptr;
+    }
+}
+
+SoundBank::~SoundBank() {
+    for (int i = 0; i < count; i++) {
+        if (chunks[i] != nullptr) {
+            Mix_FreeChunk(chunks[i]);
+        }
+    }
+}
+
+int SoundBank::load(const std::string& path) {
+    if (count == MAX_SOUNDS) return -1;
+
+    Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
+    if (chunk == nullptr) return -1;
+
+    chunks[count] = chunk;
+    return count++;
+}
+
+int SoundBank::load(SDL_RWops* source) {
+    if (source == nullptr) return -1;
+    if (count == MAX_SOUNDS) {
+        SDL_RWclose(source);
+        return -1;
+    }
+
+    Mix_Chunk* chunk = Mix_LoadWAV_RW(source, 1);
+    if (chunk == nullptr) return -1;
+
+    chunks[count] = chunk;
+    return count++;
+}
+
+int SoundBank::addSamples(std::vector<Sint16>& samples) {
+    if (count == MAX_SOUNDS) return -1;
+
+    pcm[count].swap(samples);
+    if (!pcm[count].empty()) {
+        chunks[count] = Mix_QuickLoad_RAW((Uint8*)&pcm[count][0],
+                                          (Uint32)(pcm[count].size() * sizeof(Sint16)));
+    }
+    return count++;
+}
+
+void SoundBank::play(int id) const {
+    if (id < 0 || id >= count || chunks[id] == nullptr) return;
+    AllocationScope scope(Subsystem::Audio);
+    Mix_PlayChannel(-1, chunks[id], 0);
+}
+
+// Effect Synthesis
+//
+// Each effect is a few notes; a note is a sine sweep from startHz to endHz
+// (or noise when noise is set) under a short attack and an exponential
+// decay.
+
+struct Note {
+    float startHz, endHz;
+    float seconds;
+    float volume;
+    bool noise;
+};
+
+static const Note JUMP_NOTES[] = {{300, 700, 0.12f, 0.5f, false}};
+static const Note COIN_NOTES[] = {{988, 988, 0.06f, 0.4f, false}, {1319, 1319, 0.14f, 0.4f, false}};
+static const Note HEART_NOTES[] = {{523, 523, 0.07f, 0.4f, false},
+                                   {659, 659, 0.07f, 0.4f, false},
+                                   {784, 784, 0.16f, 0.4f, false}};
+static const Note HIT_NOTES[] = {{0, 0, 0.2f, 0.6f, true}, {120, 60, 0.15f, 0.5f, false}};
+
+struct Effect {
+    const char* name;
+    const Note* notes;
+    int noteCount;
+};
+
+// Same order as GameSound
+static const Effect GAME_EFFECTS[NUM_GAME_SOUNDS] = {
+    {"jump", JUMP_NOTES, 1},
+    {"coin", COIN_NOTES, 2},
+    {"heart", HEART_NOTES, 3},
+    {"hit", HIT_NOTES, 2},
+};
+
+static void synthesize(const Effect& effect, int frequency, int channels, std::vector<Sint16>& out) {
+    // Private noise generator so the game's rand() sequence is untouched
+    Uint32 noiseState = 0x9E3779B9u;
+
+    float seconds = 0;
+    for (int n = 0; n < effect.noteCount; n++) {
+        seconds += effect.notes[n].seconds;
+    }
+    out.reserve((size_t)(seconds * frequency + 1) * channels);
+
+    for (int n = 0; n < effect.noteCount; n++) {
+        const Note& note = effect.notes[n];
+        int frames = (int)(note.seconds * frequency);
+        float phase = 0;
+        float filtered = 0;
+        for (int i = 0; i < frames; i++) {
+            float t = (float)i / frames;
+            float envelope = std::min(1.0f, i / (0.005f * frequency)) * std::exp(-4.0f * t);
+
+            float sample;
+            if (note.noise) {
+                noiseState = noiseState * 1664525u + 1013904223u;
+                float white = (float)(noiseState >> 8) / (1 << 24) * 2 - 1;
+                filtered += (white - filtered) * 0.3f;
+                sample = filtered;
+            } else {
+                float hz = note.startHz + (note.endHz - note.startHz) * t;
+                phase += 2 * 3.14159265f * hz / frequency;
+                sample = std::sin(phase);
+            }
+
+            Sint16 value = (Sint16)(sample * envelope * note.volume * 32767);
+            for (int c = 0; c < channels; c++) {
+                out.push_back(value);
+            }
+        }
+    }
+}
+
+void loadGameSounds(SoundBank& bank, const AssetArchive& assets) {
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+    bool mixerOpen = Mix_QuerySpec(&frequency, &format, &channels) != 0;
+    if (mixerOpen) {
+        Mix_AllocateChannels(SOUND_VOICES);
+    }
+
+    for (int i = 0; i < NUM_GAME_SOUNDS; i++) {
+        std::string name = std::string("sfx/") + GAME_EFFECTS[i].name + ".wav";
+        if (bank.load(assets.openAsset(name)) >= 0) continue;
+
+        std::vector<Sint16> samples;
+        if (mixerOpen && format == AUDIO_S16SYS) {
+            synthesize(GAME_EFFECTS[i], frequency, channels, samples);
+        } else if (mixerOpen) {
+            std::cout << "No sound effect for " << GAME_EFFECTS[i].name
+                      << ": mixer format is not 16-bit" << std::endl;
+        }
+        bank.addSamples(samples);
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <SDL2/SDL_mixer.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AssetArchive.h"
+#include "Constants.h"
+
+// Most sounds a bank can hold, and mixer channels (voices) allocated up
+// front; a sound played while every voice is busy is dropped.
+const int MAX_SOUNDS = 32;
+const int SOUND_VOICES = 16;
+
+// The one audio context: opens the audio device and mixer, owns the
+// background music, and closes everything when destroyed. Construct it
+// after the SDL_Plotter (so it is torn down before SDL_Quit) and before
+// anything that holds sounds. Opening is a separate step so it can wait
+// until the first frame is on screen.
+class AudioContext {
+   private:
+    bool opened;
+    Mix_Music* music;
+    bool musicStarted;
+
+    // Music is loaded and its decoder set up on this thread
+    std::thread loader;
+    std::atomic<bool> musicLoaded;
+    Mix_Music* loadedMusic;  // written by loader before musicLoaded is set
+
+    // description: loader thread body; opens the music stream
+    // return: void
+    // precondition: run on the loader thread
+    // postcondition: loadedMusic set (nullptr on failure), musicLoaded true
+    void loadMusic(SDL_RWops* source);
+
+   public:
+    // description: makes a context with the device still closed
+    // return: N/A (constructor)
+    // precondition: none
+    // postcondition: isOpen() false
+    AudioContext();
+
+    // description: stops and frees the music, closes the mixer
+    // return: N/A (destructor)
+    // precondition: sounds using the mixer already freed
+    // postcondition: loader joined, audio device closed
+    ~AudioContext();
+
+    // description: opens the audio device and mixer
+    // return: bool, true if the mixer is usable
+    // precondition: bufferSize is a power of two, in sample frames;
+    //               called at most once
+    // postcondition: mixer open, or an error printed and audio disabled
+    bool open(int bufferSize = DEFAULT_AUDIO_BUFFER);
+
+    // description: check the audio device opened
+    // return: bool, true if the mixer is usable
+    // precondition: none
+    // postcondition: none
+    bool isOpen() const;
+
+    // description: starts loading looping background music in the
+    //              background; it begins playing from update() once ready
+    // return: void
+    // precondition: called at most once; source from
+    //               AssetArchive::openAsset (may be nullptr)
+    // postcondition: loader thread owns source if audio is open,
+    //                otherwise source is closed
+    void loadMusicAsync(SDL_RWops* source);
+
+    // description: starts the music once the loader has finished
+    // return: bool, true on the call that started the music
+    // precondition: called regularly from the main thread (once a frame)
+    // postcondition: music playing if it has loaded
+    bool update();
+};
+
+// Sound effects decoded into memory once and played by integer id.
+// Playing is a single Mix_PlayChannel call: SDL_mixer mixes every voice
+// in its own audio callback, so there are no threads to wake and nothing
+// is allocated per play.
+class SoundBank {
+   private:
+    Mix_Chunk* chunks[MAX_SOUNDS];
+    std::vector<Sint16> pcm[MAX_SOUNDS];  // samples behind synthesized chunks
+    int count;
+
+   public:
+    // description: makes an empty bank
+    // return: N/A (constructor)
+    // precondition: none
+    // postcondition: bank holds no sounds
+    SoundBank();
+
+    // description: frees every sound in the bank
+    // return: N/A (destructor)
+    // precondition: the mixer is still open
+    // postcondition: chunks freed
+    ~SoundBank();
+
+    SoundBank(const SoundBank&) = delete;
+    SoundBank& operator=(const SoundBank&) = delete;
+
+    // description: decodes a sound file (WAV, OGG, ...) into the bank
+    // return: int sound id, or -1 if the file could not be decoded
+    // precondition: mixer open
+    // postcondition: sound ready to play
+    int load(const std::string& path);
+
+    // description: decodes a sound from a stream into the bank
+    // return: int sound id, or -1 if source is nullptr or undecodable
+    // precondition: mixer open
+    // postcondition: source closed; sound ready to play
+    int load(SDL_RWops* source);
+
+    // description: adds raw signed 16-bit samples in the mixer's format
+    // return: int sound id; the slot is silent if the mixer is closed
+    // precondition: samples are interleaved for the mixer's channel count
+    // postcondition: samples moved into the bank, sound ready to play
+    int addSamples(std::vector<Sint16>& samples);
+
+    // description: starts a sound on a free voice
+    // return: void
+    // precondition: id returned by load or addSamples
+    // postcondition: sound playing, or dropped if no voice is free
+    void play(int id) const;
+};
+
+// description: fills bank with the game's effects so each GameSound value
+//              is its id; the asset sfx/<name>.wav is used when present,
+//              otherwise the effect is synthesized
+// return: void
+// precondition: bank empty, mixer open
+// postcondition: NUM_GAME_SOUNDS sounds in bank
+void loadGameSounds(SoundBank& bank, const AssetArchive& assets);
+
+#endif
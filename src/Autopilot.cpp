@@ -0,0 +1,175 @@
+#include "Autopilot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+
+#include "Constants.h"
+
+// Keys for the actions searched: nothing, left, right, jump
+static const char ACTION_KEYS[Autopilot::ACTION_COUNT] = {0, 'a', 'd', 'w'};
+
+// How far ahead a decision looks: a screen of track, but no more than a
+// few seconds, so the horizon shrinks as the game speeds up. The
+// follow-up action comes an eighth of the way in.
+const float LOOKAHEAD_DISTANCE = SCREEN_HEIGHT;
+const int MAX_HORIZON_TICKS = 3000 / TICK_MS;
+const int MIN_HORIZON_TICKS = 4;
+
+// A life outweighs any score a few seconds can bring, and losing the
+// last one outweighs everything. Losses weigh the square of the ticks
+// left in the horizon, so a hit that only looks sure because the
+// rollout stops steering does not hide one that can still be dodged
+// now. A heart is worth less than any hit: lives are capped, so taking
+// a hit can make room for a heart, and that must never look like a
+// good trade.
+const long long LIFE_VALUE = 1000000;
+const long long GAME_OVER_VALUE = 100 * LIFE_VALUE;
+const long long HEART_VALUE = LIFE_VALUE / 2;
+
+// How long the start and game-over screens stay up before the autopilot
+// presses on
+const int SCREEN_TICKS = 1000 / TICK_MS;
+
+Autopilot::Autopilot(const GameConfig& config, int threads)
+    : config(config),
+      root(nullptr),
+      horizonTicks(0),
+      generation(0),
+      nextAction(ACTION_COUNT),
+      pending(0),
+      stopping(false),
+      screenTicks(0),
+      decisions(0),
+      searchMicros(0),
+      worstMicros(0),
+      games(0),
+      bestScore(0) {
+    if (threads <= 0) {
+        threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, ACTION_COUNT);
+    scratch.resize(2 * threads);
+    for (int i = 1; i < threads; i++) {
+        workers.emplace_back(&Autopilot::workerLoop, this, i);
+    }
+}
+
+Autopilot::~Autopilot() {
+    stopping.store(true, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void Autopilot::workerLoop(int index) {
+    unsigned seen = 0;
+    while (true) {
+        generation.wait(seen, std::memory_order_acquire);
+        seen = generation.load(std::memory_order_acquire);
+        if (stopping.load(std::memory_order_acquire)) return;
+        searchActions(index);
+    }
+}
+
+void Autopilot::searchActions(int index) {
+    GameState& branch = scratch[2 * index];
+    GameState& rollout = scratch[2 * index + 1];
+    // Taking an action synchronizes with the reset of nextAction, so root
+    // is the current search's
+    int action;
+    while ((action = nextAction.fetch_add(1, std::memory_order_acq_rel)) < ACTION_COUNT) {
+        values[action] = searchAction(action, branch, rollout);
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pending.notify_all();
+        }
+    }
+}
+
+long long Autopilot::searchAction(int action, GameState& branch, GameState& rollout) const {
+    // The search never looks at particles; drop them, though they still
+    // draw from the generator as they would in the game
+    root->copyTo(branch);
+    branch.particleCount = 0;
+    branch.particleLimit = 0;
+    if (ACTION_KEYS[action] != 0) {
+        branch.applyKey(config, ACTION_KEYS[action]);
+    }
+    int followUpTicks = std::max(1, horizonTicks / 8);
+    long long sofar = simulate(branch, 0, followUpTicks);
+
+    long long best = LLONG_MIN;
+    for (int followUp = 0; followUp < ACTION_COUNT; followUp++) {
+        branch.copyTo(rollout);
+        if (ACTION_KEYS[followUp] != 0 && rollout.gameState == STATE_PLAYING) {
+            rollout.applyKey(config, ACTION_KEYS[followUp]);
+        }
+        long long v = sofar + simulate(rollout, followUpTicks, horizonTicks);
+        best = std::max(best, v + (rollout.score - root->score));
+    }
+    return best;
+}
+
+long long Autopilot::simulate(GameState& state, int from, int to) const {
+    long long v = 0;
+    for (int t = from; t < to && state.gameState == STATE_PLAYING; t++) {
+        int lives = state.lives;
+        state.step(config);
+        long long weight = (long long)(horizonTicks - t) * (horizonTicks - t);
+        if (state.lives < lives) {
+            v -= (lives - state.lives) * LIFE_VALUE * weight;
+        } else {
+            v += (state.lives - lives) * HEART_VALUE;
+        }
+        if (state.gameState == STATE_GAME_OVER) {
+            v -= GAME_OVER_VALUE * weight;
+        }
+    }
+    return v;
+}
+
+char Autopilot::choose(const GameState& state) {
+    if (state.gameState == STATE_PAUSED) return 0;
+    if (state.gameState != STATE_PLAYING) {
+        if (++screenTicks < SCREEN_TICKS) return 0;
+        screenTicks = 0;
+        games++;
+        return state.gameState == STATE_START ? ' ' : 'r';
+    }
+    bestScore = std::max(bestScore, state.score);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    root = &state;
+    horizonTicks = std::clamp((int)(LOOKAHEAD_DISTANCE / (float)state.scrollSpeed), MIN_HORIZON_TICKS, MAX_HORIZON_TICKS);
+    pending.store(ACTION_COUNT, std::memory_order_relaxed);
+    nextAction.store(0, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+    searchActions(0);
+    int left;
+    while ((left = pending.load(std::memory_order_acquire)) != 0) {
+        pending.wait(left, std::memory_order_acquire);
+    }
+
+    // Ties go to the earlier action, so the autopilot only moves when
+    // moving is better than standing still
+    int best = 0;
+    for (int action = 1; action < ACTION_COUNT; action++) {
+        if (values[action] > values[best]) best = action;
+    }
+
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    decisions++;
+    searchMicros += us;
+    worstMicros = std::max(worstMicros, us);
+    return ACTION_KEYS[best];
+}
+
+void Autopilot::report() const {
+    std::printf("autopilot: %llu decisions on %zu threads, %.1f us mean, %.1f us worst; %d games, best score %d\n",
+                decisions, workers.size() + 1, decisions > 0 ? searchMicros / decisions : 0.0, worstMicros, games,
+                bestScore);
+}
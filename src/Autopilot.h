@@ -0,0 +1,112 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Config.h"
+#include "GameState.h"
+
+// Plays the game by searching ahead on copies of its state. Each tick it
+// tries every action (nothing, left, right, jump), each followed a
+// moment later by every action again, simulates each without sound
+// until a screen of track has gone by (a few seconds at most) and picks
+// the first action whose best continuation keeps the most lives and
+// score. The copies carry the game's random
+// generator, so the search sees exactly what is coming. Start and
+// game-over screens are passed with the keys a player would press.
+//
+// The first actions are shared out between persistent worker threads and
+// the caller. Every search state is allocated up front, so a decision
+// neither allocates nor starts a thread, and the choice depends only on
+// the state, never on how many threads searched.
+class Autopilot {
+   public:
+    static const int ACTION_COUNT = 4;
+
+   private:
+    const GameConfig& config;
+    std::vector<std::thread> workers;
+    std::vector<GameState> scratch;  // two per searching thread
+
+    // The search in progress. A search starts when nextAction is reset
+    // and generation bumped; pending counts the actions not yet valued.
+    const GameState* root;
+    int horizonTicks;
+    long long values[ACTION_COUNT];
+    std::atomic<unsigned> generation;
+    std::atomic<int> nextAction;
+    std::atomic<int> pending;
+    std::atomic<bool> stopping;
+
+    int screenTicks;  // ticks the current start or game-over screen has shown
+
+    unsigned long long decisions;
+    double searchMicros;
+    double worstMicros;
+    int games;
+    int bestScore;
+
+    // description: worker thread body: searches whenever generation
+    //              changes, until stopping
+    // return: void
+    // precondition: index is the worker's scratch pair, from 1
+    // postcondition: returns once stopping is set
+    void workerLoop(int index);
+
+    // description: values first actions until none are left
+    // return: void
+    // precondition: a search is in progress; index is the calling
+    //               thread's scratch pair
+    // postcondition: values filled for the actions this thread took
+    void searchActions(int index);
+
+    // description: plays one first action and every follow-up on copies
+    //              of root
+    // return: long long, the value of the best follow-up
+    // precondition: branch and rollout belong to the calling thread
+    // postcondition: root unchanged
+    long long searchAction(int action, GameState& branch, GameState& rollout) const;
+
+    // description: steps a copy through ticks from..to of the horizon,
+    //              stopping early at a game over
+    // return: long long, the value of the lives gained and lost on the
+    //         way, sooner ones weighing more; higher is better
+    // precondition: state is a search copy
+    // postcondition: state advanced
+    long long simulate(GameState& state, int from, int to) const;
+
+   public:
+    // description: starts the worker threads
+    // return: N/A (constructor)
+    // precondition: config outlives the autopilot; threads >= 1, or 0
+    //               for one per core
+    // postcondition: threads - 1 workers waiting (at most one per action
+    //                besides the caller)
+    Autopilot(const GameConfig& config, int threads = 0);
+
+    // description: stops and joins the workers
+    // return: N/A (destructor)
+    // precondition: no choose in progress
+    // postcondition: workers joined
+    ~Autopilot();
+
+    Autopilot(const Autopilot&) = delete;
+    Autopilot& operator=(const Autopilot&) = delete;
+
+    // description: decides the key to press before the next tick
+    // return: char, the key, or 0 for none
+    // precondition: called from one thread at a time, once per tick;
+    //               state is the game's current state
+    // postcondition: statistics updated; a paused game is left paused
+    char choose(const GameState& state);
+
+    // description: prints decision timings, games played and best score
+    // return: void
+    // precondition: no choose in progress
+    // postcondition: none
+    void report() const;
+};
+
+#endif
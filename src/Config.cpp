@@ -0,0 +1,105 @@
+#include "Config.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "Constants.h"
+
+GameConfig::GameConfig()
+    : gravity(GRAVITY),
+      jumpVelocity(JUMP_VELOCITY),
+      baseScrollSpeed(BASE_SCROLL_SPEED),
+      levelSpeedStep(LEVEL_SPEED_STEP),
+      obstacleSpawnChance(OBSTACLE_SPAWN_CHANCE),
+      collectibleSpawnChance(COLLECTIBLE_SPAWN_CHANCE),
+      heartSpawnChance(HEART_SPAWN_CHANCE),
+      heartRespawnChance(HEART_RESPAWN_CHANCE),
+      audioBufferSize(DEFAULT_AUDIO_BUFFER) {}
+
+// One entry per profile key: where it lands in GameConfig and the range
+// it has to fall in. Exactly one of the two field pointers is set.
+// powerOfTwo also requires an integer key to be a power of two.
+struct ProfileKey {
+    const char* name;
+    float GameConfig::*floatField;
+    int GameConfig::*intField;
+    float min, max;
+    bool powerOfTwo;
+};
+
+const ProfileKey PROFILE_KEYS[] = {
+    {"gravity", &GameConfig::gravity, nullptr, 0.05f, 5.0f, false},
+    {"jump_velocity", &GameConfig::jumpVelocity, nullptr, -50.0f, -1.0f, false},
+    {"base_scroll_speed", &GameConfig::baseScrollSpeed, nullptr, 0.5f, 50.0f, false},
+    {"level_speed_step", &GameConfig::levelSpeedStep, nullptr, 0.0f, 10.0f, false},
+    {"obstacle_spawn_chance", nullptr, &GameConfig::obstacleSpawnChance, 1, 1000, false},
+    {"collectible_spawn_chance", nullptr, &GameConfig::collectibleSpawnChance, 1, 1000, false},
+    {"heart_spawn_chance", nullptr, &GameConfig::heartSpawnChance, 1, 1000, false},
+    {"heart_respawn_chance", nullptr, &GameConfig::heartRespawnChance, 1, 1000, false},
+    {"audio_buffer_size", nullptr, &GameConfig::audioBufferSize, 128, 8192, true},
+};
+
+static std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+bool loadConfigProfile(const std::string& path, GameConfig& config) {
+    std::ifstream file(path.c_str());
+    if (!file) {
+        std::cout << "Failed to open profile: " << path << std::endl;
+        return false;
+    }
+
+    bool valid = true;
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            std::cout << path << ":" << lineNumber << ": expected key = value" << std::endl;
+            valid = false;
+            continue;
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+
+        const ProfileKey* entry = nullptr;
+        for (const ProfileKey& k : PROFILE_KEYS) {
+            if (key == k.name) entry = &k;
+        }
+        if (entry == nullptr) {
+            std::cout << path << ":" << lineNumber << ": unknown key '" << key << "'" << std::endl;
+            valid = false;
+            continue;
+        }
+
+        char* end = nullptr;
+        float number = std::strtof(value.c_str(), &end);
+        bool isInt = entry->intField != nullptr;
+        if (value.empty() || *end != '\0' || (isInt && number != (int)number) ||
+            number < entry->min || number > entry->max ||
+            (entry->powerOfTwo && ((int)number & ((int)number - 1)) != 0)) {
+            std::cout << path << ":" << lineNumber << ": " << key << " must be "
+                      << (isInt ? "an integer" : "a number") << " between " << entry->min
+                      << " and " << entry->max << (entry->powerOfTwo ? " and a power of two" : "")
+                      << ", got '" << value << "'" << std::endl;
+            valid = false;
+            continue;
+        }
+
+        if (isInt) {
+            config.*(entry->intField) = (int)number;
+        } else {
+            config.*(entry->floatField) = number;
+        }
+    }
+    return valid;
+}
@@ -0,0 +1,40 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <string>
+
+// Gameplay and audio tunables. Defaults come from Constants.h; a profile file can
+// override any of them at startup without a recompile. The struct is
+// flat so the game can keep its own copy and read it in the update loop.
+struct GameConfig {
+    float gravity;
+    float jumpVelocity;
+    float baseScrollSpeed;
+    float levelSpeedStep;
+
+    // Spawn densities: one in N
+    int obstacleSpawnChance;
+    int collectibleSpawnChance;
+    int heartSpawnChance;
+    int heartRespawnChance;
+
+    // Audio device buffer in sample frames; lower means snappier effects
+    int audioBufferSize;
+
+    // description: makes a config holding the built-in defaults
+    // return: N/A (constructor)
+    // precondition: none
+    // postcondition: every field set from Constants.h
+    GameConfig();
+};
+
+// description: reads a profile of "key = value" lines into config
+// return: bool, true if the file was read and every entry was valid
+// precondition: path names a readable text file; '#' starts a comment
+// postcondition: valid entries copied into config; unknown keys,
+//                out-of-range values and an audio buffer size that is
+//                not a power of two are reported and leave the field
+//                unchanged
+bool loadConfigProfile(const std::string& path, GameConfig& config);
+
+#endif
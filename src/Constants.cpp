@@ -1,61 +0,0 @@
-
-/*
-* Author: Group [N1.02] Defend Strator
-* Assignment Title: Final Project
-* Assignment Description: An infinite runner
-* Due Date: 12/07/25
-* Date Created: 12/14/2025
-* Date Last Modified: 12/07/2025
-*/
-
-#include "Constants.h"
-
-std::map<char, std::vector<int>> FONT_5X7;
-
-void initializeFont() {
-    FONT_5X7 = {
-        {'A', {0x70, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88}},
-        {'B', {0xF0, 0x88, 0x88, 0xF0, 0x88, 0x88, 0xF0}},
-        {'C', {0x70, 0x88, 0x80, 0x80, 0x80, 0x88, 0x70}},
-        {'D', {0xF0, 0x88, 0x88, 0x88, 0x88, 0x88, 0xF0}},
-        {'E', {0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0xF8}},
-        {'F', {0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0x80}},
-        {'G', {0x70, 0x88, 0x80, 0xB8, 0x88, 0x88, 0x70}},
-        {'H', {0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88}},
-        {'I', {0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70}},
-        {'J', {0x38, 0x10, 0x10, 0x10, 0x10, 0x90, 0x60}},
-        {'K', {0x88, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x88}},
-        {'L', {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xF8}},
-        {'M', {0x88, 0xD8, 0xA8, 0xA8, 0x88, 0x88, 0x88}},
-        {'N', {0x88, 0xC8, 0xA8, 0xA8, 0x98, 0x88, 0x88}},
-        {'O', {0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70}},
-        {'P', {0xF0, 0x88, 0x88, 0xF0, 0x80, 0x80, 0x80}},
-        {'Q', {0x70, 0x88, 0x88, 0x88, 0xA8, 0x90, 0x68}},
-        {'R', {0xF0, 0x88, 0x88, 0xF0, 0xA0, 0x90, 0x88}},
-        {'S', {0x70, 0x88, 0x80, 0x70, 0x08, 0x88, 0x70}},
-        {'T', {0xF8, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20}},
-        {'U', {0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70}},
-        {'V', {0x88, 0x88, 0x88, 0x88, 0x50, 0x50, 0x20}},
-        {'W', {0x88, 0x88, 0x88, 0xA8, 0xA8, 0xD8, 0x88}},
-        {'X', {0x88, 0x88, 0x50, 0x20, 0x50, 0x88, 0x88}},
-        {'Y', {0x88, 0x88, 0x50, 0x20, 0x20, 0x20, 0x20}},
-        {'Z', {0xF8, 0x08, 0x10, 0x20, 0x40, 0x80, 0xF8}},
-        {'0', {0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70}},
-        {'1', {0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70}},
-        {'2', {0x70, 0x88, 0x08, 0x30, 0x40, 0x80, 0xF8}},
-        {'3', {0xF8, 0x08, 0x10, 0x30, 0x08, 0x88, 0x70}},
-        {'4', {0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10}},
-        {'5', {0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70}},
-        {'6', {0x30, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70}},
-        {'7', {0xF8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40}},
-        {'8', {0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70}},
-        {'9', {0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60}},
-        {':', {0x00, 0x00, 0x20, 0x00, 0x00, 0x20, 0x00}},
-        {'!', {0x20, 0x20, 0x20, 0x20, 0x00, 0x20, 0x00}},
-        {' ', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
-        {'-', {0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00}},
-        {'+', {0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x00}},
-        {'x', {0x00, 0x88, 0x50, 0x20, 0x50, 0x88, 0x00}},
-        {'/', {0x08, 0x08, 0x10, 0x20, 0x40, 0x80, 0x80}},
-    };
-}
@@ -1,46 +1,117 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
-#include <map>
-#include <vector>
-
 // Screen dimensions
-const int SCREEN_WIDTH = 1000;
-const int SCREEN_HEIGHT = 600;
+constexpr int SCREEN_WIDTH = 1000;
+constexpr int SCREEN_HEIGHT = 600;
+
+// Rows and columns of framebuffer kept around the screen and never
+// shown. Shapes hanging off the screen by no more than this are drawn
+// without clipping. Larger overhangs, such as buildings and trains
+// entering, still clip, since drawing their hidden part costs more than
+// clipping it away (bench/ClipBench).
+constexpr int FRAME_GUARD = 16;
+
+// Top of the track; sky and buildings are drawn above it
+constexpr int HORIZON_Y = 250;
+
+// The background's scroll offset wraps at this many pixels. The
+// buildings (at 0.3x, 200 px apart) and the track lines (100 px apart)
+// both repeat over it, so the wrap never shows.
+constexpr int BG_SCROLL_PERIOD = 2000;
+
+// Simulation tick
+constexpr int TICK_MS = 16;
+constexpr float TICK_SECONDS = 0.016f;
 
-// Game physics
-const float GRAVITY = 0.6f;
-const float JUMP_VELOCITY = -12.0f;
-const float BASE_SCROLL_SPEED = 3.0f;
+// The animation clocks wrap at this many seconds, 1024 pi: a whole number
+// of periods of every sine the renderer takes of them, so the wrap never
+// shows. It keeps them precise as floats and within the fixed-point range.
+constexpr float TIMER_PERIOD = 3216.9909f;
+
+// How long the instructions stay up at the start of a run; their timer
+// stops there
+constexpr float INSTRUCTION_SECONDS = 8.0f;
+
+// Game physics (defaults; a config profile may override them, see Config.h)
+constexpr float GRAVITY = 0.6f;
+constexpr float JUMP_VELOCITY = -12.0f;
+constexpr float BASE_SCROLL_SPEED = 3.0f;
+constexpr float LEVEL_SPEED_STEP = 0.5f;
+
+// Where the level and the scroll speed stop climbing. Every profile's
+// speed at MAX_LEVEL fits the fixed-point range; the cap on the speed
+// keeps a whole tick's move within a few screens.
+constexpr int MAX_LEVEL = 1000;
+constexpr float MAX_SCROLL_SPEED = 1000.0f;
 
 // Player constants
-const int PLAYER_Y_GROUND = 450;
-const int PLAYER_WIDTH = 40;
-const int PLAYER_HEIGHT = 50;
+constexpr int PLAYER_Y_GROUND = 450;
+constexpr int PLAYER_WIDTH = 40;
+constexpr int PLAYER_HEIGHT = 50;
+// Body plus legs; the span used for obstacle collisions
+constexpr int PLAYER_HITBOX_HEIGHT = 70;
+constexpr int START_LIVES = 3;
+constexpr int MAX_LIVES = 5;
+
+// Rows of obstacles and collectibles placed at the start of a run
+constexpr int INITIAL_SPAWN_ROWS = 10;
+// Live particles are capped so the particle list never grows mid-game
+constexpr int MAX_PARTICLES = 512;
+
+// Ticks of play kept for rewinding (about five seconds)
+constexpr int REWIND_TICKS = 5000 / TICK_MS;
 
 // Lane positions
-const int LANE_POSITIONS[] = {225, 475, 725};
-const int NUM_LANES = 3;
-const int LANE_SPACING = 250;
+constexpr int NUM_LANES = 3;
+constexpr int LANE_SPACING = 250;
+// Rail x and obstacle left edge for each lane
+inline constexpr int LANE_POSITIONS[NUM_LANES] = {225, 475, 725};
+// Player left edge and collectible centre for each lane
+inline constexpr int LANE_TRACK_X[NUM_LANES] = {250, 500, 750};
+
+// Obstacle geometry, indexed by Obstacle::type (0 barrier, 1 train, 2 sign)
+constexpr int NUM_OBSTACLE_TYPES = 3;
+inline constexpr int OBSTACLE_WIDTH[NUM_OBSTACLE_TYPES] = {120, 180, 120};
+inline constexpr int OBSTACLE_HEIGHT[NUM_OBSTACLE_TYPES] = {50, 80, 50};
+
+// Collectibles closer than this to the player (in y) are picked up
+constexpr int COLLECT_DISTANCE = 40;
+
+// Spawn densities (defaults): one in N of each kind
+constexpr int OBSTACLE_SPAWN_CHANCE = 3;
+constexpr int COLLECTIBLE_SPAWN_CHANCE = 2;
+constexpr int HEART_SPAWN_CHANCE = 10;
+constexpr int HEART_RESPAWN_CHANCE = 15;
+
+// Mouse/touch drags at least this long (in pixels) count as swipes
+constexpr int SWIPE_DISTANCE = 40;
 
 // Game states
-const int STATE_START = 0;
-const int STATE_PLAYING = 1;
-const int STATE_PAUSED = 2;
-const int STATE_GAME_OVER = 3;
-
-// 5x7 Bitmap Font
-extern std::map<char, std::vector<int>> FONT_5X7;
-//************************************************************
-// description:Initializes the FONT_5X7 map with hexadecimal *
-//              values representing the 5x7 bitmap patterns  *
-//              for alphanumeric characters and symbols.     *
-// return: void                                              *
-// precondition: The FONT_5X7 map must be declared and       *
-//               accessible in the current scope.            *
-// postcondition: FONT_5X7 is populated with character keys  *
-//                mapped to their specific 5x7 hex vectors.  *
-//************************************************************
-void initializeFont();
+constexpr int STATE_START = 0;
+constexpr int STATE_PLAYING = 1;
+constexpr int STATE_PAUSED = 2;
+constexpr int STATE_GAME_OVER = 3;
+
+// Input chars SDL_Plotter::getKey gives for keys without a character of
+// their own
+constexpr char UP_ARROW = 1;
+constexpr char DOWN_ARROW = 2;
+constexpr char LEFT_ARROW = 3;
+constexpr char RIGHT_ARROW = 4;
+constexpr char BACKSPACE = 8;
+
+// Sound ids of the game's effects once loadGameSounds has run
+enum GameSound {
+    SOUND_JUMP,
+    SOUND_COIN,
+    SOUND_HEART,
+    SOUND_HIT,
+    NUM_GAME_SOUNDS
+};
+
+// Default audio device buffer, in sample frames. Smaller buffers start
+// effects sooner but underrun more easily on a busy machine.
+constexpr int DEFAULT_AUDIO_BUFFER = 1024;
 
 #endif
@@ -0,0 +1,155 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <array>
+#include <cstdint>
+
+// A signed 16.16 fixed-point number for the simulation. Every operation
+// is integer arithmetic with its rounding written out, so a result is
+// the same bits whatever the compiler, its flags (-ffast-math, FMA
+// contraction, vectorization) or the CPU, which float cannot promise.
+//
+// The range is about +-32768 in steps of 1/65536. Addition and
+// subtraction wrap at the ends of the range instead of overflowing;
+// products and quotients are worked out in 64 bits and rounded toward
+// minus infinity, then wrap the same way.
+//
+// The simulation keeps every value well inside the range, so it never
+// wraps there and the float and fixed builds stay alike however long a
+// run lasts: positions stay within a few screens, the level stops at
+// MAX_LEVEL and the scroll speed at MAX_SCROLL_SPEED, the background
+// offset wraps at BG_SCROLL_PERIOD, the animation clocks at TIMER_PERIOD,
+// and the instruction timer stops at INSTRUCTION_SECONDS (Constants.h).
+class Fixed {
+   public:
+    static constexpr int FRACTION_BITS = 16;
+    static constexpr int32_t ONE = 1 << FRACTION_BITS;
+
+   private:
+    int32_t raw;
+
+    // Two's complement wrap of a 64-bit result, without the undefined
+    // behaviour of signed overflow
+    static constexpr int32_t wrap(int64_t value) {
+        return (int32_t)(uint32_t)(uint64_t)value;
+    }
+
+   public:
+    // Uninitialized, as a float would be, so arrays of objects holding
+    // Fixed stay trivial to construct
+    Fixed() = default;
+
+    // description: makes a whole number
+    // precondition: value within the range
+    constexpr Fixed(int value) : raw(wrap((int64_t)value * ONE)) {}
+
+    // A float or double would otherwise turn into a whole number through
+    // the int constructor; converting one has to be asked for
+    Fixed(double) = delete;
+
+    // description: makes the nearest fixed-point number to a float, for
+    //              constants and config values; the result is exact
+    //              double arithmetic, so it does not depend on the build
+    // precondition: value within the range
+    explicit constexpr Fixed(float value) : raw(0) {
+        double scaled = (double)value * ONE;
+        raw = (int32_t)(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    }
+
+    // description: makes a number from its 16.16 bits
+    // return: Fixed
+    // precondition: none
+    // postcondition: none
+    static constexpr Fixed fromRaw(int32_t bits) {
+        Fixed f(0);
+        f.raw = bits;
+        return f;
+    }
+
+    // description: gets the 16.16 bits, for hashing and comparing runs
+    // return: int32_t
+    // precondition: none
+    // postcondition: none
+    constexpr int32_t rawValue() const { return raw; }
+
+    // Truncates toward zero, as converting a float does
+    explicit constexpr operator int() const { return raw / ONE; }
+
+    // For drawing and observations; never fed back into the simulation
+    explicit constexpr operator float() const { return (float)raw / ONE; }
+
+    constexpr Fixed operator-() const { return fromRaw(wrap(-(int64_t)raw)); }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) { return fromRaw(wrap((int64_t)a.raw + b.raw)); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) { return fromRaw(wrap((int64_t)a.raw - b.raw)); }
+    friend constexpr Fixed operator*(Fixed a, Fixed b) {
+        return fromRaw(wrap(((int64_t)a.raw * b.raw) >> FRACTION_BITS));
+    }
+    // precondition: b is not zero
+    friend constexpr Fixed operator/(Fixed a, Fixed b) {
+        int64_t n = (int64_t)a.raw * ONE;
+        int64_t q = n / b.raw;
+        // Toward minus infinity, to match the product's rounding
+        if ((n % b.raw != 0) && ((n < 0) != (b.raw < 0))) q--;
+        return fromRaw(wrap(q));
+    }
+
+    // Whole-number factors are exact and do not have to fit the range
+    // themselves, only the product does
+    friend constexpr Fixed operator*(Fixed a, int b) { return fromRaw(wrap((int64_t)a.raw * b)); }
+    friend constexpr Fixed operator*(int a, Fixed b) { return b * a; }
+
+    constexpr Fixed& operator+=(Fixed b) { return *this = *this + b; }
+    constexpr Fixed& operator-=(Fixed b) { return *this = *this - b; }
+    constexpr Fixed& operator*=(Fixed b) { return *this = *this * b; }
+    constexpr Fixed& operator/=(Fixed b) { return *this = *this / b; }
+
+    friend constexpr bool operator==(Fixed a, Fixed b) = default;
+    friend constexpr auto operator<=>(Fixed a, Fixed b) = default;
+};
+
+// description: builds sin for every whole degree in 16.16, at compile
+//              time and in integer arithmetic only (a Taylor series in
+//              2.30 fixed point over the first quadrant, mirrored into
+//              the others), so the table cannot depend on a math library
+// return: std::array<Fixed, 360>, sin of 0..359 degrees
+// precondition: none
+// postcondition: none
+constexpr std::array<Fixed, 360> makeSinDegrees() {
+    // pi in 2.30
+    constexpr int64_t PI_30 = 3373259426;
+    constexpr int SHIFT = 30 - Fixed::FRACTION_BITS;
+
+    int32_t quadrant[91] = {};
+    for (int degrees = 0; degrees <= 90; degrees++) {
+        int64_t x = PI_30 * degrees / 180;
+        int64_t x2 = (x * x) >> 30;
+        int64_t term = x;
+        int64_t sum = 0;
+        for (int n = 1; term != 0; n += 2) {
+            sum += term;
+            term = -((term * x2) >> 30) / ((n + 1) * (n + 2));
+        }
+        quadrant[degrees] = (int32_t)((sum + (1 << (SHIFT - 1))) >> SHIFT);
+    }
+
+    std::array<Fixed, 360> table = {};
+    for (int degrees = 0; degrees < 360; degrees++) {
+        int32_t s;
+        if (degrees <= 90) {
+            s = quadrant[degrees];
+        } else if (degrees <= 180) {
+            s = quadrant[180 - degrees];
+        } else if (degrees <= 270) {
+            s = -quadrant[degrees - 180];
+        } else {
+            s = -quadrant[360 - degrees];
+        }
+        table[degrees] = Fixed::fromRaw(s);
+    }
+    return table;
+}
+
+inline constexpr std::array<Fixed, 360> FIXED_SIN_DEGREES = makeSinDegrees();
+
+#endif
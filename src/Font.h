@@ -0,0 +1,151 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <array>
+
+// 5x7 bitmap font. Each glyph is one byte per row, top row first, with the
+// leftmost pixel in bit 7 (so only the top five bits are used).
+constexpr int FONT_GLYPH_WIDTH = 5;
+constexpr int FONT_GLYPH_HEIGHT = 7;
+
+struct Glyph {
+    unsigned char rows[FONT_GLYPH_HEIGHT];
+};
+
+// The table is indexed directly by ASCII code. Control codes and DEL are
+// blank; every printable character from ' ' to '~' has a glyph. To add or
+// change a glyph, edit its row below.
+constexpr int FONT_GLYPH_COUNT = 128;
+
+inline constexpr std::array<Glyph, FONT_GLYPH_COUNT> FONT_5X7 = {{
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x00
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x01
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x02
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x03
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x04
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x05
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x06
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x07
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x08
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x09
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x0A
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x0B
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x0C
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x0D
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x0E
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x0F
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x10
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x11
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x12
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x13
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x14
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x15
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x16
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x17
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x18
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x19
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x1A
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x1B
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x1C
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x1D
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x1E
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x1F
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // ' '
+    {{0x20, 0x20, 0x20, 0x20, 0x00, 0x20, 0x00}},  // '!'
+    {{0x50, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00}},  // '"'
+    {{0x50, 0x50, 0xF8, 0x50, 0xF8, 0x50, 0x50}},  // '#'
+    {{0x20, 0x78, 0xA0, 0x70, 0x28, 0xF0, 0x20}},  // '$'
+    {{0xC0, 0xC8, 0x10, 0x20, 0x40, 0x98, 0x18}},  // '%'
+    {{0x60, 0x90, 0xA0, 0x40, 0xA8, 0x90, 0x68}},  // '&'
+    {{0x20, 0x20, 0x40, 0x00, 0x00, 0x00, 0x00}},  // '\''
+    {{0x10, 0x20, 0x40, 0x40, 0x40, 0x20, 0x10}},  // '('
+    {{0x40, 0x20, 0x10, 0x10, 0x10, 0x20, 0x40}},  // ')'
+    {{0x00, 0x20, 0xA8, 0x70, 0xA8, 0x20, 0x00}},  // '*'
+    {{0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x00}},  // '+'
+    {{0x00, 0x00, 0x00, 0x00, 0x60, 0x20, 0x40}},  // ','
+    {{0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00}},  // '-'
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x60}},  // '.'
+    {{0x08, 0x08, 0x10, 0x20, 0x40, 0x80, 0x80}},  // '/'
+    {{0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70}},  // '0'
+    {{0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70}},  // '1'
+    {{0x70, 0x88, 0x08, 0x30, 0x40, 0x80, 0xF8}},  // '2'
+    {{0xF8, 0x08, 0x10, 0x30, 0x08, 0x88, 0x70}},  // '3'
+    {{0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10}},  // '4'
+    {{0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70}},  // '5'
+    {{0x30, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70}},  // '6'
+    {{0xF8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40}},  // '7'
+    {{0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70}},  // '8'
+    {{0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60}},  // '9'
+    {{0x00, 0x00, 0x20, 0x00, 0x00, 0x20, 0x00}},  // ':'
+    {{0x00, 0x60, 0x60, 0x00, 0x60, 0x20, 0x40}},  // ';'
+    {{0x10, 0x20, 0x40, 0x80, 0x40, 0x20, 0x10}},  // '<'
+    {{0x00, 0x00, 0xF8, 0x00, 0xF8, 0x00, 0x00}},  // '='
+    {{0x40, 0x20, 0x10, 0x08, 0x10, 0x20, 0x40}},  // '>'
+    {{0x70, 0x88, 0x08, 0x10, 0x20, 0x00, 0x20}},  // '?'
+    {{0x70, 0x88, 0x08, 0x68, 0xA8, 0xA8, 0x70}},  // '@'
+    {{0x70, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88}},  // 'A'
+    {{0xF0, 0x88, 0x88, 0xF0, 0x88, 0x88, 0xF0}},  // 'B'
+    {{0x70, 0x88, 0x80, 0x80, 0x80, 0x88, 0x70}},  // 'C'
+    {{0xF0, 0x88, 0x88, 0x88, 0x88, 0x88, 0xF0}},  // 'D'
+    {{0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0xF8}},  // 'E'
+    {{0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0x80}},  // 'F'
+    {{0x70, 0x88, 0x80, 0xB8, 0x88, 0x88, 0x70}},  // 'G'
+    {{0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88}},  // 'H'
+    {{0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70}},  // 'I'
+    {{0x38, 0x10, 0x10, 0x10, 0x10, 0x90, 0x60}},  // 'J'
+    {{0x88, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x88}},  // 'K'
+    {{0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xF8}},  // 'L'
+    {{0x88, 0xD8, 0xA8, 0xA8, 0x88, 0x88, 0x88}},  // 'M'
+    {{0x88, 0xC8, 0xA8, 0xA8, 0x98, 0x88, 0x88}},  // 'N'
+    {{0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70}},  // 'O'
+    {{0xF0, 0x88, 0x88, 0xF0, 0x80, 0x80, 0x80}},  // 'P'
+    {{0x70, 0x88, 0x88, 0x88, 0xA8, 0x90, 0x68}},  // 'Q'
+    {{0xF0, 0x88, 0x88, 0xF0, 0xA0, 0x90, 0x88}},  // 'R'
+    {{0x70, 0x88, 0x80, 0x70, 0x08, 0x88, 0x70}},  // 'S'
+    {{0xF8, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20}},  // 'T'
+    {{0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70}},  // 'U'
+    {{0x88, 0x88, 0x88, 0x88, 0x50, 0x50, 0x20}},  // 'V'
+    {{0x88, 0x88, 0x88, 0xA8, 0xA8, 0xD8, 0x88}},  // 'W'
+    {{0x88, 0x88, 0x50, 0x20, 0x50, 0x88, 0x88}},  // 'X'
+    {{0x88, 0x88, 0x50, 0x20, 0x20, 0x20, 0x20}},  // 'Y'
+    {{0xF8, 0x08, 0x10, 0x20, 0x40, 0x80, 0xF8}},  // 'Z'
+    {{0x70, 0x40, 0x40, 0x40, 0x40, 0x40, 0x70}},  // '['
+    {{0x80, 0x80, 0x40, 0x20, 0x10, 0x08, 0x08}},  // '\\'
+    {{0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x70}},  // ']'
+    {{0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00}},  // '^'
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8}},  // '_'
+    {{0x40, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00}},  // '`'
+    {{0x00, 0x00, 0x70, 0x08, 0x78, 0x88, 0x78}},  // 'a'
+    {{0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0xF0}},  // 'b'
+    {{0x00, 0x00, 0x70, 0x80, 0x80, 0x88, 0x70}},  // 'c'
+    {{0x08, 0x08, 0x68, 0x98, 0x88, 0x88, 0x78}},  // 'd'
+    {{0x00, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x70}},  // 'e'
+    {{0x30, 0x48, 0x40, 0xE0, 0x40, 0x40, 0x40}},  // 'f'
+    {{0x00, 0x78, 0x88, 0x88, 0x78, 0x08, 0x70}},  // 'g'
+    {{0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0x88}},  // 'h'
+    {{0x20, 0x00, 0x60, 0x20, 0x20, 0x20, 0x70}},  // 'i'
+    {{0x10, 0x00, 0x30, 0x10, 0x10, 0x90, 0x60}},  // 'j'
+    {{0x80, 0x80, 0x90, 0xA0, 0xC0, 0xA0, 0x90}},  // 'k'
+    {{0x60, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70}},  // 'l'
+    {{0x00, 0x00, 0xD0, 0xA8, 0xA8, 0x88, 0x88}},  // 'm'
+    {{0x00, 0x00, 0xB0, 0xC8, 0x88, 0x88, 0x88}},  // 'n'
+    {{0x00, 0x00, 0x70, 0x88, 0x88, 0x88, 0x70}},  // 'o'
+    {{0x00, 0x00, 0xF0, 0x88, 0xF0, 0x80, 0x80}},  // 'p'
+    {{0x00, 0x00, 0x68, 0x98, 0x78, 0x08, 0x08}},  // 'q'
+    {{0x00, 0x00, 0xB0, 0xC8, 0x80, 0x80, 0x80}},  // 'r'
+    {{0x00, 0x00, 0x70, 0x80, 0x70, 0x08, 0xF0}},  // 's'
+    {{0x40, 0x40, 0xE0, 0x40, 0x40, 0x48, 0x30}},  // 't'
+    {{0x00, 0x00, 0x88, 0x88, 0x88, 0x98, 0x68}},  // 'u'
+    {{0x00, 0x00, 0x88, 0x88, 0x88, 0x50, 0x20}},  // 'v'
+    {{0x00, 0x00, 0x88, 0x88, 0xA8, 0xA8, 0x50}},  // 'w'
+    {{0x00, 0x88, 0x50, 0x20, 0x50, 0x88, 0x00}},  // 'x'
+    {{0x00, 0x00, 0x88, 0x88, 0x78, 0x08, 0x70}},  // 'y'
+    {{0x00, 0x00, 0xF8, 0x10, 0x20, 0x40, 0xF8}},  // 'z'
+    {{0x10, 0x20, 0x20, 0x40, 0x20, 0x20, 0x10}},  // '{'
+    {{0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20}},  // '|'
+    {{0x40, 0x20, 0x20, 0x10, 0x20, 0x20, 0x40}},  // '}'
+    {{0x00, 0x00, 0x40, 0xA8, 0x10, 0x00, 0x00}},  // '~'
+    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // 0x7F
+}};
+
+#endif
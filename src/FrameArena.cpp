@@ -0,0 +1,44 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+FrameArena::FrameArena(size_t capacity)
+    : buffer(new char[capacity]), capacity(capacity), used(0), highWater(0), reportedFull(false) {}
+
+FrameArena::~FrameArena() {
+    delete[] buffer;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t align) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+    size_t start = ((base + used + align - 1) & ~(uintptr_t)(align - 1)) - base;
+    if (start + bytes > capacity) {
+        if (!reportedFull) {
+            std::cout << "FrameArena Error: " << capacity << " byte arena is full" << std::endl;
+            reportedFull = true;
+        }
+        return nullptr;
+    }
+
+    used = start + bytes;
+    highWater = std::max(highWater, used);
+    return buffer + start;
+}
+
+size_t FrameArena::mark() const {
+    return used;
+}
+
+void FrameArena::rewind(size_t mark) {
+    used = mark;
+}
+
+void FrameArena::reset() {
+    used = 0;
+}
+
+size_t FrameArena::getHighWater() const {
+    return highWater;
+}
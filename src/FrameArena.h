@@ -0,0 +1,99 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+
+// Bump allocator for data that only lives until the end of a frame:
+// formatted strings, draw-command lists and scratch buffers. The buffer is
+// allocated once; allocating moves a pointer, and reset() at the top of
+// each frame frees everything at once. Nothing is destroyed, so only
+// trivially destructible types belong here.
+class FrameArena {
+   private:
+    char* buffer;
+    size_t capacity;
+    size_t used;
+    size_t highWater;
+    bool reportedFull;
+
+   public:
+    // description: makes an arena of the given size
+    // return: N/A (constructor)
+    // precondition: capacity > 0
+    // postcondition: buffer allocated, arena empty
+    explicit FrameArena(size_t capacity);
+
+    // description: frees the buffer
+    // return: N/A (destructor)
+    // precondition: nothing still points into the arena
+    // postcondition: buffer freed
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // description: carves bytes out of the arena
+    // return: void* (aligned block, or nullptr when the arena is full)
+    // precondition: align is a power of two
+    // postcondition: block valid until the next reset or rewind past it;
+    //                the first overflow is reported once
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+
+    // description: carves an array of count T out of the arena
+    // return: T* (uninitialized storage, or nullptr when full)
+    // precondition: T is trivially destructible
+    // postcondition: as allocate
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // description: formats prefix followed by an integer into the arena
+    // return: std::string_view (the text, or just the prefix when full)
+    // precondition: Integer is an integer type
+    // postcondition: the view stays valid until the next reset
+    template <typename Integer>
+    std::string_view format(std::string_view prefix, Integer value) {
+        // Sign and every digit the type can hold
+        const size_t digits = std::numeric_limits<Integer>::digits10 + 2;
+        char* text = allocateArray<char>(prefix.size() + digits);
+        if (text == nullptr) return prefix;
+
+        char* end = std::copy(prefix.begin(), prefix.end(), text);
+        end = std::to_chars(end, end + digits, value).ptr;
+        // This was the last allocation, so the unused digits can go back
+        used = end - buffer;
+        return std::string_view(text, end - text);
+    }
+
+    // description: marks the current fill level, for rewind
+    // return: size_t
+    // precondition: none
+    // postcondition: none
+    size_t mark() const;
+
+    // description: frees everything allocated since mark was taken,
+    //              for scratch buffers that die before the frame ends
+    // return: void
+    // precondition: mark came from mark() since the last reset
+    // postcondition: arena back to that fill level
+    void rewind(size_t mark);
+
+    // description: frees everything; called at the top of every frame
+    // return: void
+    // precondition: nothing still points into the arena
+    // postcondition: arena empty; high-water mark kept
+    void reset();
+
+    // description: reports the most the arena has held at once
+    // return: size_t bytes
+    // precondition: none
+    // postcondition: none
+    size_t getHighWater() const;
+};
+
+#endif
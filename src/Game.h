@@ -1,77 +1,167 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include <SDL2/SDL_mixer.h>
-
 #include <vector>
 
+#include "Audio.h"
+#include "Config.h"
 #include "GameObjects.h"
+#include "GameSnapshot.h"
+#include "GameState.h"
+#include "LatencyProbe.h"
 #include "Renderer.h"
 #include "SDL_Plotter.h"
+#include "Telemetry.h"
 
 class SubwaySurferGame {
    private:
     SDL_Plotter& plotter;
     Renderer renderer;
-    int screenWidth, screenHeight;
-
-    int currentLane;
-    float playerY;
-    float verticalVelocity;
-    bool isJumping;
-    float animTime;
-
-    std::vector<Obstacle> obstacles;
-    std::vector<Collectible> collectibles;
-    std::vector<Particle> particles;
-    int score, lives, level;
-    float gameTime;
-    float scrollSpeed;
-    int gameState;
-
-    float bgScroll;
-    int comboMultiplier;
-    float comboTimer;
-    bool showInstructions;
-    float instructionTimer;
-    Mix_Music* bgMusic;
-
-    // description: puts initial obstacles in the game
+    GameConfig config;
+
+    // Everything the simulation changes; see GameState
+    GameState state;
+    SoundBank sounds;
+
+    // Mouse/touch drag in progress, for swipe controls
+    bool dragging;
+    int dragStartX, dragStartY;
+
+    // Memory telemetry overlay, toggled with 't'
+    const Telemetry* telemetry;
+    bool showTelemetry;
+
+    // Told about every key press the game applies, when set
+    LatencyProbe* latencyProbe;
+
+    // The state at the start of each of the last REWIND_TICKS ticks of
+    // play, as a ring; rewinding walks back through it one tick per tick
+    // while the rewind key is held
+    std::vector<GameState> history;
+    int historyHead;   // slot the next tick goes into
+    int historyCount;
+    bool rewinding;
+
+    // description: applies one input event, turning mouse drags into
+    //              lane-switch and jump swipes, and taps into start,
+    //              jump or restart
     // return: void
-    // precondition: game initialized
-    // postcondition: obstacles vector filled with starting obstacles
-    void spawnInitialObstacles();
+    // precondition: e came from the input queue; tickEnd is the end of
+    //               the tick applying it
+    // postcondition: key handled, or drag state updated
+    void handleEvent(const InputEvent& e, Uint32 tickEnd);
 
-    // description: makes particle effects at a spot
+    // description: applies one key press to the game
     // return: void
-    // precondition: coords and colors valid
-    // postcondition: count particles added to vector with r,g,b colors
-    void spawnParticles(int x, int y, int count, int r, int g, int b);
+    // precondition: key is input char
+    // postcondition: quit, overlay or rewind handled here; anything else
+    //                applied to the state
+    void handleKey(char key);
+
+    // description: plays the sounds a state change asked for
+    // return: void
+    // precondition: events from GameState::applyKey or step
+    // postcondition: one effect started per bit set
+    void playSounds(SoundEvents events);
+
+    // description: advances the game by one fixed tick, or takes it one
+    //              tick back while rewinding
+    // return: void
+    // precondition: none
+    // postcondition: state stepped and saved to history if playing;
+    //                restored from the newest history entry if rewinding
+    void step();
+
+    // description: draws the track, objects, HUD and any pause or
+    //              game-over screen of a snapshot
+    // return: void
+    // precondition: frame.gameState is not STATE_START
+    // postcondition: frame drawn, apart from the telemetry overlay
+    void drawPlayfield(const GameSnapshot& frame);
 
 public:
     // description: makes the game object
     // return: N/A (constructor)
-    // precondition: SDL_Plotter initialized
-    // postcondition: game created with starting values, music loaded
-    SubwaySurferGame(SDL_Plotter& g);
+    // precondition: SDL_Plotter initialized, config validated
+    // postcondition: game created with starting values, ready to draw
+    //                the start screen; obstacles are spawned when play
+    //                starts; the same seed and input give the same game
+    SubwaySurferGame(SDL_Plotter& g, const GameConfig& config, unsigned seed);
 
-    // description: cleans up game object
-    // return: N/A (destructor)
-    // precondition: game exists
-    // postcondition: music freed, game destroyed
-    ~SubwaySurferGame();
+    // description: loads the sound effects
+    // return: void
+    // precondition: audio context open
+    // postcondition: effects loaded from assets (or synthesized); until
+    //                then effects are silent
+    void loadSounds(const AssetArchive& assets);
+
+    // description: applies queued input, then advances one tick
+    // return: void
+    // precondition: tickEnd is the SDL tick (ms) at which this tick ends
+    // postcondition: every event stamped at or before tickEnd consumed
+    //                in order; player moved, obstacles updated,
+    //                collisions checked, score changed
+    void update(InputQueue& input, Uint32 tickEnd);
 
-    // description: updates game based on key pressed
+    // description: copies everything render needs into a snapshot, so the
+    //              simulation can move on while the snapshot is drawn
     // return: void
-    // precondition: game state valid, key is input char
-    // postcondition: player moved, obstacles updated, collisions checked, score changed
-    void update(char key);
+    // precondition: called from the thread that calls update
+    // postcondition: frame holds this tick's state; its tick and tickEnd
+    //                are left to the caller
+    void writeSnapshot(GameSnapshot& frame) const;
 
-    // description: draws everything to screen
+    // description: draws a snapshot to screen
     // return: void
-    // precondition: game state valid, plotter ready
+    // precondition: plotter ready; may run on another thread than update,
+    //               as it reads only frame and renderer state
     // postcondition: game objects and UI drawn on screen
-    void render();
+    void render(const GameSnapshot& frame);
+
+    // description: checks whether the game changes without input: while
+    //              playing or rewinding, as the start, pause and
+    //              game-over screens are otherwise still
+    // return: bool
+    // precondition: called from the thread that calls update
+    // postcondition: none
+    bool isAnimating() const;
+
+    // description: gives the game the telemetry its overlay shows
+    // return: void
+    // precondition: t outlives the game, or is nullptr
+    // postcondition: 't' toggles the overlay when t is set
+    void setTelemetry(const Telemetry* t);
+
+    // description: gives the game a probe to tell about applied keys
+    // return: void
+    // precondition: probe outlives the game, or is nullptr
+    // postcondition: each key press handled is passed to the probe
+    void setLatencyProbe(LatencyProbe* probe);
+
+    // description: reports container fill levels
+    // return: void
+    // precondition: called once per frame, after render(frame)
+    // postcondition: obstacle, collectible and particle fill sampled from
+    //                the snapshot, frame arena fill from the renderer
+    void sampleTelemetry(const GameSnapshot& frame, Telemetry& t) const;
+
+    // description: gets the current score
+    // return: int
+    // precondition: none
+    // postcondition: none
+    int getScore() const;
+
+    // description: gets the whole simulated state, e.g. to branch it
+    // return: const GameState&
+    // precondition: called from the thread that calls update
+    // postcondition: none
+    const GameState& getState() const;
+
+    // description: replaces the simulated state with a saved one
+    // return: void
+    // precondition: s came from getState of a game with the same config
+    // postcondition: the game continues from s; rewind history kept
+    void setState(const GameState& s);
 
     // description: resets game back to start
     // return: void
@@ -1,9 +1,24 @@
 #ifndef GAMEOBJECTS_H
 #define GAMEOBJECTS_H
 
-struct Obstacle {
+#include "Constants.h"
+#include "Fixed.h"
+
+// The number type of every simulated position, speed and timer. Builds
+// with SUBWAY_FIXED_POINT simulate in 16.16 fixed point, which gives the
+// same results on every compiler and machine; the default is float. The
+// objects and GameState are templates on it so both can be built side
+// by side, as the benchmark does.
+#ifdef SUBWAY_FIXED_POINT
+typedef Fixed SimScalar;
+#else
+typedef float SimScalar;
+#endif
+
+template <class Scalar>
+struct BasicObstacle {
     int lane;
-    float y;
+    Scalar y;
     int type;
     bool active;
 
@@ -26,12 +41,13 @@ struct Obstacle {
     int getHeight() const;
 };
 
-struct Collectible {
+template <class Scalar>
+struct BasicCollectible {
     int lane;
-    float y;
+    Scalar y;
     int type;
     bool active;
-    float animTime;
+    Scalar animTime;
 
     //description: Get x coordinate of collectible
     //return: int
@@ -40,11 +56,39 @@ struct Collectible {
     int getX() const;
 };
 
-struct Particle {
-    float x, y, vx, vy;
+template <class Scalar>
+struct BasicParticle {
+    Scalar x, y, vx, vy;
     int r, g, b;
-    float life, maxLife;
+    Scalar life, maxLife;
     int size;
 };
 
+typedef BasicObstacle<SimScalar> Obstacle;
+typedef BasicCollectible<SimScalar> Collectible;
+typedef BasicParticle<SimScalar> Particle;
+
+// The getters read the constexpr geometry tables in Constants.h and are
+// defined here so they inline into the update and draw loops.
+
+template <class Scalar>
+inline int BasicObstacle<Scalar>::getX() const {
+    return LANE_POSITIONS[lane];
+}
+
+template <class Scalar>
+inline int BasicObstacle<Scalar>::getWidth() const {
+    return OBSTACLE_WIDTH[type];
+}
+
+template <class Scalar>
+inline int BasicObstacle<Scalar>::getHeight() const {
+    return OBSTACLE_HEIGHT[type];
+}
+
+template <class Scalar>
+inline int BasicCollectible<Scalar>::getX() const {
+    return LANE_TRACK_X[lane];
+}
+
 #endif
@@ -0,0 +1,23 @@
+#ifndef GAMESNAPSHOT_H
+#define GAMESNAPSHOT_H
+
+#include <SDL2/SDL.h>
+
+#include "GameState.h"
+
+// Everything the renderer needs to draw one tick, copied out of the game
+// by the simulation thread and handed to the render thread. The game
+// state is a single trivially copyable block, so refilling a snapshot is
+// one copy and never allocates.
+struct GameSnapshot {
+    Uint32 tick;     // ticks simulated so far
+    Uint32 tickEnd;  // SDL tick (ms) at which the last of them ended
+
+    GameState state;
+    bool showTelemetry;
+    bool rewinding;
+
+    GameSnapshot() : tick(0), tickEnd(0), showTelemetry(false), rewinding(false) {}
+};
+
+#endif
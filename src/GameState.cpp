@@ -0,0 +1,504 @@
+#include "GameState.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <execution>
+
+// FNV-1a taken a 32-bit word at a time instead of a byte: a quarter of
+// the multiplies, and plenty to tell two states apart
+class WordHash {
+   private:
+    uint32_t h = 2166136261u;
+
+   public:
+    void add(uint32_t word) { h = (h ^ word) * 16777619u; }
+    void add(int value) { add((uint32_t)value); }
+    void add(bool value) { add((uint32_t)value); }
+    void add(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        add(bits);
+    }
+    void add(Fixed value) { add((uint32_t)value.rawValue()); }
+    uint32_t value() const { return h; }
+};
+
+const char* stateFieldName(StateField field) {
+    switch (field) {
+        case StateField::Rng:
+            return "rng";
+        case StateField::Player:
+            return "player";
+        case StateField::Progress:
+            return "progress";
+        case StateField::Timers:
+            return "timers";
+        case StateField::Obstacles:
+            return "obstacles";
+        case StateField::Collectibles:
+            return "collectibles";
+        default:
+            return "particles";
+    }
+}
+
+uint64_t StateHash::combined() const {
+    uint64_t h = 14695981039346656037ull;
+    for (uint32_t field : fields) {
+        h = (h ^ field) * 1099511628211ull;
+    }
+    return h;
+}
+
+GameRng::GameRng() {
+    seed(1);
+}
+
+void GameRng::seed(unsigned s) {
+    // As glibc's srandom: a Lehmer generator fills the table, then the
+    // first ten rounds of output are thrown away
+    if (s == 0) s = 1;
+    int32_t word = (int32_t)s;
+    table[0] = word;
+    for (int i = 1; i < DEGREE; i++) {
+        // word = 16807 * word % 2147483647, without overflowing 31 bits
+        long long hi = word / 127773;
+        long long lo = word % 127773;
+        word = (int32_t)(16807 * lo - 2836 * hi);
+        if (word < 0) word += 2147483647;
+        table[i] = word;
+    }
+    front = SEPARATION;
+    rear = 0;
+    for (int i = 0; i < DEGREE * 10; i++) {
+        next();
+    }
+}
+
+int GameRng::next() {
+    uint32_t value = (uint32_t)table[front] + (uint32_t)table[rear];
+    table[front] = (int32_t)value;
+    front = front + 1 == DEGREE ? 0 : front + 1;
+    rear = rear + 1 == DEGREE ? 0 : rear + 1;
+    // The lowest bit is the least random; drop it
+    return (int)(value >> 1);
+}
+
+uint32_t GameRng::hash() const {
+    WordHash h;
+    for (int32_t word : table) {
+        h.add((uint32_t)word);
+    }
+    h.add(front);
+    h.add(rear);
+    return h.value();
+}
+
+// Whether an offset moving steadily from `from` to `to` during a tick is
+// strictly between low and high at some point of it. Collisions test the
+// offset of an object from the player on the scroll axis this way, so an
+// object that moves further than its overlap window in one tick is still
+// caught on its way through instead of jumping over the player.
+static bool sweptInside(int from, int to, int low, int high) {
+    return std::min(from, to) < high && std::max(from, to) > low;
+}
+
+// Brings an animation clock back below TIMER_PERIOD once it reaches it,
+// so it never runs out of precision or range however long a run lasts
+template <class Scalar>
+static void wrapTimer(Scalar& time) {
+    if (time >= Scalar(TIMER_PERIOD)) {
+        time -= Scalar(TIMER_PERIOD);
+    }
+}
+
+// Launch velocity of a particle thrown at a whole number of degrees. The
+// float game keeps the math library's trig it has always used; fixed
+// point reads the generated table, so it cannot vary with the library.
+static void launchVelocity(int degrees, float speed, float& vx, float& vy) {
+    float angle = degrees * 3.14159f / 180.0f;
+    vx = cos(angle) * speed;
+    vy = sin(angle) * speed - 3;
+}
+
+static void launchVelocity(int degrees, Fixed speed, Fixed& vx, Fixed& vy) {
+    vx = FIXED_SIN_DEGREES[(degrees + 90) % 360] * speed;
+    vy = FIXED_SIN_DEGREES[degrees] * speed - 3;
+}
+
+template <class Scalar>
+StateHash BasicGameState<Scalar>::hash() const {
+    StateHash result;
+    result.fields[(int)StateField::Rng] = rng.hash();
+
+    WordHash player;
+    player.add(currentLane);
+    player.add(tickLane);
+    player.add(playerY);
+    player.add(verticalVelocity);
+    player.add(isJumping);
+    result.fields[(int)StateField::Player] = player.value();
+
+    WordHash progress;
+    progress.add(gameState);
+    progress.add(score);
+    progress.add(lives);
+    progress.add(level);
+    progress.add(comboMultiplier);
+    progress.add(showInstructions);
+    result.fields[(int)StateField::Progress] = progress.value();
+
+    WordHash timers;
+    timers.add(animTime);
+    timers.add(gameTime);
+    timers.add(scrollSpeed);
+    timers.add(bgScroll);
+    timers.add(comboTimer);
+    timers.add(instructionTimer);
+    result.fields[(int)StateField::Timers] = timers.value();
+
+    WordHash obstacleHash;
+    obstacleHash.add(obstacleCount);
+    for (int i = 0; i < obstacleCount; i++) {
+        const BasicObstacle<Scalar>& obs = obstacles[i];
+        obstacleHash.add(obs.lane);
+        obstacleHash.add(obs.y);
+        obstacleHash.add(obs.type);
+        obstacleHash.add(obs.active);
+    }
+    result.fields[(int)StateField::Obstacles] = obstacleHash.value();
+
+    WordHash collectibleHash;
+    collectibleHash.add(collectibleCount);
+    for (int i = 0; i < collectibleCount; i++) {
+        const BasicCollectible<Scalar>& col = collectibles[i];
+        collectibleHash.add(col.lane);
+        collectibleHash.add(col.y);
+        collectibleHash.add(col.type);
+        collectibleHash.add(col.active);
+        collectibleHash.add(col.animTime);
+    }
+    result.fields[(int)StateField::Collectibles] = collectibleHash.value();
+
+    // Four chains instead of one, so their multiplies overlap; particles
+    // are most of the words hashed
+    WordHash motion, velocity, look, life;
+    motion.add(particleCount);
+    for (int i = 0; i < particleCount; i++) {
+        const BasicParticle<Scalar>& p = particles[i];
+        motion.add(p.x);
+        motion.add(p.y);
+        velocity.add(p.vx);
+        velocity.add(p.vy);
+        look.add(p.r);
+        look.add(p.g);
+        look.add(p.b);
+        look.add(p.size);
+        life.add(p.life);
+        life.add(p.maxLife);
+    }
+    WordHash particleHash;
+    particleHash.add(motion.value());
+    particleHash.add(velocity.value());
+    particleHash.add(look.value());
+    particleHash.add(life.value());
+    result.fields[(int)StateField::Particles] = particleHash.value();
+    return result;
+}
+
+template <class Scalar>
+void BasicGameState<Scalar>::copyTo(BasicGameState& dest) const {
+    // Particles come last, so the live ones end the part worth copying;
+    // most ticks that is a small fraction of the whole
+    std::memcpy(&dest, this, offsetof(BasicGameState, particles) + particleCount * sizeof(BasicParticle<Scalar>));
+}
+
+template <class Scalar>
+void BasicGameState<Scalar>::reset(const GameConfig& config, unsigned seed) {
+    rng.seed(seed);
+    gameState = STATE_START;
+    currentLane = 1;
+    tickLane = currentLane;
+    playerY = PLAYER_Y_GROUND;
+    verticalVelocity = 0;
+    isJumping = false;
+    animTime = 0;
+    score = 0;
+    lives = START_LIVES;
+    level = 1;
+    gameTime = 0;
+    scrollSpeed = Scalar(config.baseScrollSpeed);
+    bgScroll = 0;
+    comboMultiplier = 1;
+    comboTimer = 0;
+    showInstructions = true;
+    instructionTimer = 0;
+    obstacleCount = 0;
+    collectibleCount = 0;
+    particleCount = 0;
+    particleLimit = MAX_PARTICLES;
+}
+
+template <class Scalar>
+void BasicGameState<Scalar>::restart(const GameConfig& config) {
+    score = 0;
+    lives = START_LIVES;
+    level = 1;
+    gameTime = 0;
+    scrollSpeed = Scalar(config.baseScrollSpeed);
+    currentLane = 1;
+    tickLane = currentLane;
+    playerY = PLAYER_Y_GROUND;
+    isJumping = false;
+    verticalVelocity = 0;
+    comboMultiplier = 1;
+    comboTimer = 0;
+    gameState = STATE_PLAYING;
+    instructionTimer = 0;
+    particleCount = 0;
+    spawnInitialObstacles(config);
+}
+
+template <class Scalar>
+void BasicGameState<Scalar>::spawnInitialObstacles(const GameConfig& config) {
+    obstacleCount = 0;
+    collectibleCount = 0;
+
+    for (int i = 0; i < INITIAL_SPAWN_ROWS; i++) {
+        if (rng.next() % config.obstacleSpawnChance == 0) {
+            BasicObstacle<Scalar>& obs = obstacles[obstacleCount++];
+            obs.lane = rng.next() % NUM_LANES;
+            obs.y = -i * 180;
+            obs.type = rng.next() % NUM_OBSTACLE_TYPES;
+            obs.active = true;
+        }
+
+        if (rng.next() % config.collectibleSpawnChance == 0) {
+            BasicCollectible<Scalar>& col = collectibles[collectibleCount++];
+            col.lane = rng.next() % NUM_LANES;
+            col.y = -i * 180 - 90;
+            col.type = (rng.next() % config.heartSpawnChance == 0) ? 1 : 0;
+            col.active = true;
+            col.animTime = 0;
+        }
+    }
+}
+
+template <class Scalar>
+void BasicGameState<Scalar>::spawnParticles(int x, int y, int count, int r, int g, int b) {
+    for (int i = 0; i < count; i++) {
+        BasicParticle<Scalar> p;
+        p.x = x;
+        p.y = y;
+        int degrees = rng.next() % 360;
+        Scalar speed = 2 + rng.next() % 5;
+        launchVelocity(degrees, speed, p.vx, p.vy);
+        p.r = r + (rng.next() % 50) - 25;
+        p.g = g + (rng.next() % 50) - 25;
+        p.b = b + (rng.next() % 50) - 25;
+        p.life = p.maxLife = Scalar(1) + Scalar(rng.next() % 100) / 100;
+        p.size = 2 + rng.next() % 3;
+        // Past the cap the particle is dropped, after its draws so the
+        // rest of the game sees the same sequence
+        if (particleCount < particleLimit) {
+            particles[particleCount++] = p;
+        }
+    }
+}
+
+template <class Scalar>
+SoundEvents BasicGameState<Scalar>::applyKey(const GameConfig& config, char key) {
+    if (gameState == STATE_START) {
+        if (key == ' ' || key == 's') {
+            gameState = STATE_PLAYING;
+            instructionTimer = 0;
+            spawnInitialObstacles(config);
+        }
+        return 0;
+    }
+
+    if (gameState == STATE_GAME_OVER) {
+        if (key == 'r') {
+            restart(config);
+        }
+        return 0;
+    }
+
+    if (key == 'p') {
+        gameState = (gameState == STATE_PLAYING) ? STATE_PAUSED : STATE_PLAYING;
+        return 0;
+    }
+
+    if (gameState != STATE_PLAYING) return 0;
+
+    SoundEvents sounds = 0;
+    if ((key == 'a' || key == LEFT_ARROW) && currentLane > 0) {
+        currentLane--;
+    }
+    if ((key == 'd' || key == RIGHT_ARROW) && currentLane < NUM_LANES - 1) {
+        currentLane++;
+    }
+    if ((key == 'w' || key == UP_ARROW || key == ' ') && !isJumping) {
+        verticalVelocity = Scalar(config.jumpVelocity);
+        isJumping = true;
+        sounds |= 1u << SOUND_JUMP;
+        spawnParticles(LANE_TRACK_X[currentLane], (int)(playerY + PLAYER_HITBOX_HEIGHT), 10, 200, 200, 255);
+    }
+    return sounds;
+}
+
+template <class Scalar>
+SoundEvents BasicGameState<Scalar>::step(const GameConfig& config) {
+    const Scalar dt = Scalar(TICK_SECONDS);
+    SoundEvents sounds = 0;
+
+    if (instructionTimer < Scalar(INSTRUCTION_SECONDS)) {
+        instructionTimer += dt;
+    }
+
+    gameTime += dt;
+    animTime += dt;
+    wrapTimer(gameTime);
+    wrapTimer(animTime);
+    bgScroll += scrollSpeed;
+    // Kept small, so it stays precise and within a fixed-point range
+    while (bgScroll >= BG_SCROLL_PERIOD) {
+        bgScroll -= BG_SCROLL_PERIOD;
+    }
+
+    if (comboTimer > 0) {
+        comboTimer -= dt;
+        if (comboTimer <= 0) {
+            comboMultiplier = 1;
+        }
+    }
+
+    // Where the player started the tick. Everything moves in a straight
+    // line within a tick, the jump arc included, so collisions sweep from
+    // these positions to the new ones.
+    int playerFrom = (int)playerY;
+    bool sweep = currentLane == tickLane;
+    tickLane = currentLane;
+    if (isJumping) {
+        verticalVelocity += Scalar(config.gravity);
+        playerY += verticalVelocity;
+
+        if (playerY >= PLAYER_Y_GROUND) {
+            playerY = PLAYER_Y_GROUND;
+            isJumping = false;
+            verticalVelocity = 0;
+        }
+    }
+
+    for (int i = 0; i < obstacleCount; i++) {
+        BasicObstacle<Scalar>& obs = obstacles[i];
+        if (!obs.active) continue;
+
+        int obsFrom = (int)obs.y;
+        obs.y += scrollSpeed;
+
+        // Swept over the whole move before it can respawn, so one that
+        // passes the player and leaves the screen in the same tick still
+        // hits
+        if (currentLane == obs.lane) {
+            // The hitboxes overlap while the obstacle's top is less than
+            // the player's height below the player's top and less than
+            // its own height above it
+            int to = (int)obs.y - (int)playerY;
+            int from = sweep ? obsFrom - playerFrom : to;
+
+            if (sweptInside(from, to, -obs.getHeight(), PLAYER_HITBOX_HEIGHT)) {
+                lives--;
+                comboMultiplier = 1;
+                comboTimer = 0;
+                sounds |= 1u << SOUND_HIT;
+                spawnParticles(LANE_TRACK_X[currentLane], (int)playerY, 30, 255, 100, 100);
+
+                if (lives <= 0) {
+                    gameState = STATE_GAME_OVER;
+                }
+                obs.y = -100 - rng.next() % 200;
+                continue;
+            }
+        }
+
+        if (obs.y > SCREEN_HEIGHT + 100) {
+            obs.y = -100 - rng.next() % 200;
+            obs.lane = rng.next() % NUM_LANES;
+            obs.type = rng.next() % NUM_OBSTACLE_TYPES;
+            score += 5 * comboMultiplier;
+        }
+    }
+
+    for (int i = 0; i < collectibleCount; i++) {
+        BasicCollectible<Scalar>& col = collectibles[i];
+        if (!col.active) continue;
+
+        int colFrom = (int)col.y;
+        col.y += scrollSpeed;
+        col.animTime += dt;
+        wrapTimer(col.animTime);
+
+        // Picked up over the whole move, before it can respawn
+        if (currentLane == col.lane) {
+            int to = (int)col.y - (int)playerY;
+            int from = sweep ? colFrom - playerFrom : to;
+            if (sweptInside(from, to, -COLLECT_DISTANCE, COLLECT_DISTANCE)) {
+                col.active = false;
+                if (col.type == 0) {
+                    score += 10 * comboMultiplier;
+                    comboMultiplier++;
+                    comboTimer = 3;
+                    sounds |= 1u << SOUND_COIN;
+                    spawnParticles(col.getX(), (int)col.y, 15, 255, 215, 0);
+                } else {
+                    lives = std::min(lives + 1, MAX_LIVES);
+                    sounds |= 1u << SOUND_HEART;
+                    spawnParticles(col.getX(), (int)col.y, 20, 255, 50, 100);
+                }
+                col.y = -50 - rng.next() % 300;
+                col.active = true;
+                continue;
+            }
+        }
+
+        if (col.y > SCREEN_HEIGHT + 50) {
+            col.y = -50 - rng.next() % 300;
+            col.lane = rng.next() % NUM_LANES;
+            col.type = (rng.next() % config.heartRespawnChance == 0) ? 1 : 0;
+            col.active = true;
+        }
+    }
+
+    // Particles are independent of each other and of the rng, so their
+    // update may be vectorized. A parallel policy does not pay off for a
+    // few hundred particles.
+    const Scalar particleGravity = Scalar(0.2f);
+    auto advanceParticle = [dt, particleGravity](BasicParticle<Scalar>& p) {
+        p.x += p.vx;
+        p.y += p.vy;
+        p.vy += particleGravity;
+        p.life -= dt;
+    };
+#if defined(__cpp_lib_execution) && __cpp_lib_execution >= 201902L
+    std::for_each(std::execution::unseq, particles, particles + particleCount, advanceParticle);
+#else
+    std::for_each(particles, particles + particleCount, advanceParticle);
+#endif
+    BasicParticle<Scalar>* live = std::remove_if(particles, particles + particleCount,
+                                                 [](const BasicParticle<Scalar>& p) { return p.life <= 0; });
+    particleCount = (int)(live - particles);
+
+    scrollSpeed = std::min(Scalar(config.baseScrollSpeed) + level * Scalar(config.levelSpeedStep),
+                           Scalar(MAX_SCROLL_SPEED));
+    if (score > level * 100 && level < MAX_LEVEL) {
+        level++;
+    }
+    return sounds;
+}
+
+template struct BasicGameState<float>;
+template struct BasicGameState<Fixed>;
@@ -0,0 +1,205 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include <cstdint>
+#include <type_traits>
+
+#include "Config.h"
+#include "GameObjects.h"
+
+// Most obstacles and collectibles in play: at most one of each per row
+// placed at the start of a run, and none are added afterwards
+constexpr int MAX_OBSTACLES = INITIAL_SPAWN_ROWS;
+constexpr int MAX_COLLECTIBLES = INITIAL_SPAWN_ROWS;
+
+// Largest value GameRng::next returns
+constexpr int GAME_RAND_MAX = 2147483647;
+
+// The simulation's random number generator, kept inside the game state so
+// a copy of the state carries its place in the sequence. It is the
+// additive feedback generator behind glibc's random(3), and gives exactly
+// the numbers rand() gives after srand(seed) there, so replays recorded
+// when the game used rand() still play out the same.
+class GameRng {
+   private:
+    static const int DEGREE = 31;
+    static const int SEPARATION = 3;
+
+    int32_t table[DEGREE];
+    int front, rear;
+
+   public:
+    // description: makes a generator seeded with 1, as rand() starts
+    // return: N/A (constructor)
+    // precondition: none
+    // postcondition: next gives rand()'s sequence for seed 1
+    GameRng();
+
+    // description: restarts the sequence
+    // return: void
+    // precondition: none
+    // postcondition: next gives rand()'s sequence after srand(s)
+    void seed(unsigned s);
+
+    // description: draws the next number
+    // return: int between 0 and GAME_RAND_MAX
+    // precondition: none
+    // postcondition: generator advanced by one
+    int next();
+
+    // description: hashes the generator's place in its sequence
+    // return: uint32_t, equal for generators that will give the same
+    //         numbers
+    // precondition: none
+    // postcondition: none
+    uint32_t hash() const;
+};
+
+// The parts of a GameState hashed separately, so a desync can be traced
+// to the part that went wrong first
+enum class StateField { Rng, Player, Progress, Timers, Obstacles, Collectibles, Particles };
+const int STATE_FIELD_COUNT = 7;
+
+// description: names a state field for reports
+// return: const char* (lower case)
+// precondition: none
+// postcondition: none
+const char* stateFieldName(StateField field);
+
+// A hash of every simulated value in a GameState, one word per
+// StateField. Two states that hash the same play on identically; a
+// replay can carry one per tick to prove that a build still does.
+struct StateHash {
+    uint32_t fields[STATE_FIELD_COUNT];
+
+    bool operator==(const StateHash& other) const = default;
+
+    // description: folds the fields into one value
+    // return: uint64_t
+    // precondition: none
+    // postcondition: none
+    uint64_t combined() const;
+};
+
+// Sounds a change of state asks for, one bit per GameSound. The state
+// never plays them itself, so a copy can be stepped silently.
+typedef unsigned SoundEvents;
+
+// The whole simulated game in one trivially copyable block: no pointers,
+// fixed-size object arrays and the random generator inline. Copying it is
+// a snapshot and assigning it back a restore, which is what rewinding
+// and lookahead do. Everything outside it (rendering, sound, input
+// decoding, telemetry) leaves the simulation unchanged.
+//
+// Scalar is the number type of positions, speeds and timers (see
+// SimScalar); the game uses GameState, the build's choice. Both float and
+// Fixed are instantiated in GameState.cpp.
+template <class Scalar>
+struct BasicGameState {
+    GameRng rng;
+    int gameState;
+
+    int currentLane;
+    // Lane the player ended the last tick in. Collisions sweep through a
+    // tick only in that lane; a lane moved into counts from where the
+    // tick ends.
+    int tickLane;
+    Scalar playerY;
+    Scalar verticalVelocity;
+    bool isJumping;
+    Scalar animTime;
+
+    int score, lives, level;
+    Scalar gameTime;
+    Scalar scrollSpeed;
+    Scalar bgScroll;
+    int comboMultiplier;
+    Scalar comboTimer;
+    bool showInstructions;
+    Scalar instructionTimer;
+
+    int obstacleCount;
+    int collectibleCount;
+    int particleCount;
+    // Most particles kept: MAX_PARTICLES, or 0 in copies that are only
+    // stepped to see what happens, since particles never affect play
+    int particleLimit;
+    BasicObstacle<Scalar> obstacles[MAX_OBSTACLES];
+    BasicCollectible<Scalar> collectibles[MAX_COLLECTIBLES];
+    BasicParticle<Scalar> particles[MAX_PARTICLES];
+
+    // description: hashes every value the simulation reads or draws,
+    //              field by field. Slots past the object and particle
+    //              counts and padding are left out, and so is
+    //              particleLimit, which only says how the state is used.
+    //              It is worked out afresh each call rather than kept up
+    //              as the state changes: every tick moves each object and
+    //              particle and advances the clocks, so a running hash
+    //              would rehash nearly all the same words inside step,
+    //              and every run would pay for it, not just the ones
+    //              recording or checking hashes.
+    // return: StateHash
+    // precondition: none
+    // postcondition: none
+    StateHash hash() const;
+
+    // description: copies the state, leaving out particle slots past
+    //              particleCount, which hold nothing
+    // return: void
+    // precondition: none
+    // postcondition: dest equals this state in everything the game reads
+    void copyTo(BasicGameState& dest) const;
+
+    // description: puts the game on its start screen
+    // return: void
+    // precondition: config validated
+    // postcondition: starting values, no objects, rng seeded with seed;
+    //                obstacles are spawned when play starts
+    void reset(const GameConfig& config, unsigned seed);
+
+    // description: starts a new run after a game over
+    // return: void
+    // precondition: config validated
+    // postcondition: score, lives and player reset, obstacles respawned,
+    //                playing; the rng carries on where it was
+    void restart(const GameConfig& config);
+
+    // description: applies one key press: start, pause, restart, lane
+    //              change or jump
+    // return: SoundEvents, the sounds it asks for
+    // precondition: key is an input char; 'q' and 't' are not game keys
+    // postcondition: state changed, or player moved/jumped if playing
+    SoundEvents applyKey(const GameConfig& config, char key);
+
+    // description: advances the simulation by one fixed tick
+    // return: SoundEvents, the sounds it asks for
+    // precondition: gameState is STATE_PLAYING
+    // postcondition: physics, obstacles, collectibles, particles and
+    //                score advanced by TICK_SECONDS
+    SoundEvents step(const GameConfig& config);
+
+    // description: puts initial obstacles and collectibles in the game
+    // return: void
+    // precondition: config validated
+    // postcondition: obstacle and collectible arrays refilled
+    void spawnInitialObstacles(const GameConfig& config);
+
+    // description: makes particle effects at a spot
+    // return: void
+    // precondition: coords and colors valid
+    // postcondition: count particles added with r,g,b colors, up to
+    //                particleLimit live at once
+    void spawnParticles(int x, int y, int count, int r, int g, int b);
+};
+
+extern template struct BasicGameState<float>;
+extern template struct BasicGameState<Fixed>;
+
+typedef BasicGameState<SimScalar> GameState;
+
+static_assert(std::is_trivially_copyable_v<BasicGameState<float>>, "GameState is copied as a block");
+static_assert(std::is_trivially_copyable_v<BasicGameState<Fixed>>, "GameState is copied as a block");
+static_assert(std::is_standard_layout_v<BasicGameState<float>>, "copyTo takes the offset of particles");
+static_assert(std::is_standard_layout_v<BasicGameState<Fixed>>, "copyTo takes the offset of particles");
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef INPUTQUEUE_H
+#define INPUTQUEUE_H
+
+#include <SDL2/SDL.h>
+
+#include <atomic>
+
+// Fixed-capacity, lock-free single-producer/single-consumer ring buffer.
+// One thread may push and one (possibly different) thread may peek and
+// pop; neither ever blocks or allocates. Capacity must be a power of two.
+template <typename T, unsigned Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+   private:
+    T items[Capacity];
+    std::atomic<unsigned> head;  // next slot to pop, written by the consumer
+    std::atomic<unsigned> tail;  // next slot to push, written by the producer
+
+   public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // description: adds an item at the back (producer side)
+    // return: bool, false if the queue was full and item was dropped
+    // precondition: called from the producer thread only
+    // postcondition: item visible to the consumer if true was returned
+    bool push(const T& item) {
+        unsigned t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // description: reads the front item without removing it (consumer side)
+    // return: bool, false if the queue is empty
+    // precondition: called from the consumer thread only
+    // postcondition: item holds a copy of the front item if true
+    bool peek(T& item) const {
+        unsigned h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = items[h & (Capacity - 1)];
+        return true;
+    }
+
+    // description: checks for pending items (consumer side)
+    // return: bool, true if there is nothing to pop
+    // precondition: called from the consumer thread only
+    // postcondition: queue unchanged
+    bool empty() const {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
+    // description: removes the front item (consumer side)
+    // return: bool, false if the queue is empty
+    // precondition: called from the consumer thread only
+    // postcondition: item holds the removed item if true
+    bool pop(T& item) {
+        if (!peek(item)) return false;
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Kinds of InputEvent
+const int INPUT_KEY = 0;
+const int INPUT_MOUSE_DOWN = 1;
+const int INPUT_MOUSE_UP = 2;
+const int INPUT_MOUSE_MOTION = 3;
+const int INPUT_KEY_UP = 4;
+
+// A key press or release, or a mouse action, stamped with the SDL tick
+// (ms) at which SDL received it. key is set for INPUT_KEY and
+// INPUT_KEY_UP; x and y for the mouse kinds. Only keys the game holds
+// down (BACKSPACE, for rewinding) report their release.
+struct InputEvent {
+    Uint32 timestamp;
+    int type;
+    char key;
+    int x, y;
+};
+
+typedef SpscQueue<InputEvent, 256> InputQueue;
+
+#endif
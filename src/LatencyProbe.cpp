@@ -0,0 +1,50 @@
+#include "LatencyProbe.h"
+
+#include <algorithm>
+#include <cstdio>
+
+LatencyProbe::LatencyProbe(bool enabled) : enabled(enabled), droppedKeys(0), sampleCount(0), droppedSamples(0) {}
+
+bool LatencyProbe::isEnabled() const {
+    return enabled;
+}
+
+void LatencyProbe::keyApplied(Uint32 timestamp, Uint32 tickEnd) {
+    if (!enabled) return;
+    if (!pending.push(AppliedKey{timestamp, tickEnd})) {
+        droppedKeys++;
+    }
+}
+
+void LatencyProbe::framePresented(Uint32 now, Uint32 frameTickEnd) {
+    AppliedKey key;
+    while (pending.peek(key) && (Sint32)(key.tickEnd - frameTickEnd) <= 0) {
+        pending.pop(key);
+        if (sampleCount == LATENCY_SAMPLES) {
+            droppedSamples++;
+            continue;
+        }
+        samples[sampleCount++] = now - key.timestamp;
+    }
+}
+
+void LatencyProbe::report(const char* presentMode) {
+    if (!enabled) return;
+    if (sampleCount == 0) {
+        std::printf("latency (%s): no key presses measured\n", presentMode);
+        return;
+    }
+
+    std::sort(samples, samples + sampleCount);
+    double total = 0;
+    for (int i = 0; i < sampleCount; i++) {
+        total += samples[i];
+    }
+    std::printf("latency (%s): %d keys, mean %.1f ms, median %u ms, p95 %u ms, max %u ms", presentMode,
+                sampleCount, total / sampleCount, samples[sampleCount / 2], samples[sampleCount * 95 / 100],
+                samples[sampleCount - 1]);
+    if (droppedKeys + droppedSamples > 0) {
+        std::printf(" (%llu not measured)", droppedKeys + droppedSamples);
+    }
+    std::printf("\n");
+}
@@ -0,0 +1,73 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <SDL2/SDL.h>
+
+#include "InputQueue.h"
+
+// Most key presses waiting for their frame, and most latencies kept
+const int LATENCY_PENDING = 64;
+const int LATENCY_SAMPLES = 4096;
+
+// Measures input-to-present latency (--latency-probe): for each key press,
+// the time from SDL receiving it to the return of the present of the
+// first frame drawn from a snapshot taken after the game applied it. Both
+// ends are SDL ticks, so samples have millisecond resolution. Keys are
+// applied on the simulation thread and frames presented on the main
+// thread; applied keys pass between them through a lock-free queue.
+// Everything is kept in fixed arrays; probing does not allocate.
+class LatencyProbe {
+   private:
+    // A key the game applied, waiting for its frame
+    struct AppliedKey {
+        Uint32 timestamp;  // SDL tick the key arrived at
+        Uint32 tickEnd;    // end of the tick that applied it
+    };
+
+    bool enabled;
+    SpscQueue<AppliedKey, LATENCY_PENDING> pending;
+    unsigned long long droppedKeys;  // applied while pending was full
+    Uint32 samples[LATENCY_SAMPLES];
+    int sampleCount;
+    unsigned long long droppedSamples;  // samples past LATENCY_SAMPLES
+
+   public:
+    // description: makes a probe
+    // return: N/A (constructor)
+    // precondition: none
+    // postcondition: no samples; the other calls do nothing if disabled
+    LatencyProbe(bool enabled);
+
+    // description: checks whether the probe is measuring
+    // return: bool
+    // precondition: none
+    // postcondition: none
+    bool isEnabled() const;
+
+    // description: notes that the game applied a key press
+    // return: void
+    // precondition: called from the simulation thread only; timestamp is
+    //               the SDL tick the key arrived at, tickEnd the end of
+    //               the tick that applied it
+    // postcondition: key waits for the first frame drawn from that tick
+    //                or a later one
+    void keyApplied(Uint32 timestamp, Uint32 tickEnd);
+
+    // description: closes out every key the presented frame shows
+    // return: void
+    // precondition: called from the presenting thread only; now is the SDL
+    //               tick right after the present returned, frameTickEnd
+    //               the tickEnd of the snapshot presented
+    // postcondition: one sample per key applied at or before
+    //                frameTickEnd; later keys left waiting
+    void framePresented(Uint32 now, Uint32 frameTickEnd);
+
+    // description: prints the number of samples, mean, median, 95th
+    //              percentile and worst latency
+    // return: void
+    // precondition: the simulation thread has stopped
+    // postcondition: samples sorted
+    void report(const char* presentMode);
+};
+
+#endif
@@ -1,100 +1,314 @@
 #include "Renderer.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <type_traits>
 
 #include "Constants.h"
+#include "Font.h"
+
+// Opacity of the HUD panels, the dark wash behind the pause and game-over
+// screens, and the panels drawn on top of it
+const int HUD_ALPHA = 210;
+const int OVERLAY_DIM_ALPHA = 120;
+const int OVERLAY_ALPHA = 230;
+
+// Size of the per-frame arena. A frame uses a few hundred bytes of
+// strings plus the runs of the longest string being drawn.
+const size_t RENDER_ARENA_BYTES = 64 * 1024;
 
 Renderer::Renderer(SDL_Plotter& g, int w, int h)
-    : plotter(g), screenWidth(w), screenHeight(h) {}
+    : plotter(g), screenWidth(w), screenHeight(h), flickerState(0x9E3779B9u), arena(RENDER_ARENA_BYTES) {}
+
+void Renderer::beginFrame() {
+    arena.reset();
+}
 
-void Renderer::drawChar(int x, int y, char c, int r, int g, int b, int scale) {
-    c = toupper(c);
-    if (FONT_5X7.find(c) == FONT_5X7.end()) return;
+// The lane rails are drawn without clipping whenever the screen is
+static_assert(LANE_POSITIONS[0] >= 1 && LANE_POSITIONS[NUM_LANES - 1] + 1 < SCREEN_WIDTH,
+              "lane rails must lie inside the screen");
+
+template <ClipMode Clip>
+using ClipTag = std::integral_constant<ClipMode, Clip>;
+template <BlendMode Mode>
+using BlendTag = std::integral_constant<BlendMode, Mode>;
+
+// Calls draw(clip, blend) with both modes picked once for a whole
+// primitive: transparent draws are skipped, solid ones store pixels
+// instead of blending, and ones whose bounding box is on screen skip
+// clipping. Past this point the alpha is known to be in range, so the
+// spans go straight to SDL_Plotter::blendRun.
+template <typename Draw>
+static void withModes(const SDL_Plotter& plotter, int x, int y, int w, int h, int a, Draw draw) {
+    if (a <= 0) return;
+    bool inside = plotter.contains(x, y, w, h);
+    if (a >= 255) {
+        if (inside) {
+            draw(ClipTag<ClipMode::Unclipped>(), BlendTag<BlendMode::Opaque>());
+        } else {
+            draw(ClipTag<ClipMode::Clipped>(), BlendTag<BlendMode::Opaque>());
+        }
+    } else {
+        if (inside) {
+            draw(ClipTag<ClipMode::Unclipped>(), BlendTag<BlendMode::Alpha>());
+        } else {
+            draw(ClipTag<ClipMode::Clipped>(), BlendTag<BlendMode::Alpha>());
+        }
+    }
+}
+
+// withModes for opaque shapes: calls draw(clip)
+template <typename Draw>
+static void withClip(const SDL_Plotter& plotter, int x, int y, int w, int h, Draw draw) {
+    if (plotter.contains(x, y, w, h)) {
+        draw(ClipTag<ClipMode::Unclipped>());
+    } else {
+        draw(ClipTag<ClipMode::Clipped>());
+    }
+}
 
-    std::vector<int>& charData = FONT_5X7[c];
-    for (int row = 0; row < 7; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (charData[row] & (1 << (7 - col))) {
+// Width of a string: each character advances an 8 pixel cell plus one
+// pixel of spacing, all scaled
+static int textWidth(size_t length, int scale) {
+    return (int)length * (8 * scale + scale);
+}
+
+template <ClipMode Clip, BlendMode Mode>
+void Renderer::fillSpan(int x0, int x1, int y, Uint32 color, int a) {
+    plotter.blendRun<Clip, Mode>(x0, x1, y, color, a);
+}
+
+template <ClipMode Clip, BlendMode Mode>
+void Renderer::drawGlyph(int x, int y, char c, Uint32 color, int scale, int a) {
+    unsigned char code = static_cast<unsigned char>(c);
+    if (code >= FONT_GLYPH_COUNT) return;
+
+    const Glyph& glyph = FONT_5X7[code];
+    for (int row = 0; row < FONT_GLYPH_HEIGHT; row++) {
+        for (int col = 0; col < FONT_GLYPH_WIDTH; col++) {
+            if (glyph.rows[row] & (0x80 >> col)) {
+                int px = x + col * scale;
                 for (int sy = 0; sy < scale; sy++) {
-                    for (int sx = 0; sx < scale; sx++) {
-                        int px = x + col * scale + sx;
-                        int py = y + row * scale + sy;
-                        if (px >= 0 && px < screenWidth && py >= 0 && py < screenHeight) {
-                            plotter.plotPixel(px, py, r, g, b);
-                        }
-                    }
+                    fillSpan<Clip, Mode>(px, px + scale - 1, y + row * scale + sy, color, a);
                 }
             }
         }
     }
 }
 
-void Renderer::drawText(int x, int y, const std::string& text, int r, int g, int b, int scale) {
+template <ClipMode Clip, BlendMode Mode>
+void Renderer::drawString(int x, int y, std::string_view text, int r, int g, int b, int scale, int a) {
+    Uint32 color = packColor(r, g, b);
     int currentX = x;
     for (char c : text) {
-        drawChar(currentX, y, c, r, g, b, scale);
+        drawGlyph<Clip, Mode>(currentX, y, c, color, scale, a);
         currentX += 8 * scale + scale;
     }
 }
 
-void Renderer::drawTextCentered(int y, const std::string& text, int r, int g, int b, int scale) {
-    int textWidth = text.length() * (8 * scale + scale);
-    int x = (screenWidth - textWidth) / 2;
-    drawText(x, y, text, r, g, b, scale);
+template <ClipMode Clip, BlendMode Mode>
+void Renderer::fillGradient(int x, int y, int w, int h, int r1, int g1, int b1, int r2, int g2, int b2, int a) {
+    // Every row lies between the two end colors, so clamping those once
+    // keeps each row in range
+    r1 = clampChannel(r1);
+    g1 = clampChannel(g1);
+    b1 = clampChannel(b1);
+    r2 = clampChannel(r2);
+    g2 = clampChannel(g2);
+    b2 = clampChannel(b2);
+    for (int py = 0; py < h; py++) {
+        float ratio = (float)py / h;
+        int r = r1 + (int)((r2 - r1) * ratio);
+        int g = g1 + (int)((g2 - g1) * ratio);
+        int b = b1 + (int)((b2 - b1) * ratio);
+
+        fillSpan<Clip, Mode>(x, x + w - 1, y + py, RED_SHIFT * r + GREEN_SHIFT * g + BLUE_SHIFT * b, a);
+    }
 }
 
-void Renderer::drawTextWithShadow(int x, int y, const std::string& text, int r, int g, int b, int scale) {
-    drawText(x + 2, y + 2, text, 0, 0, 0, scale);
-    drawText(x, y, text, r, g, b, scale);
+template <ClipMode Clip, BlendMode Mode>
+void Renderer::fillBox(int x, int y, int w, int h, int r, int g, int b, int a) {
+    fillGradient<Clip, Mode>(x, y, w, h, r, g, b, r - 10, g - 10, b - 10, a);
+
+    constexpr Uint32 border = packColor(200, 200, 150);
+    fillSpan<Clip, Mode>(x, x + w - 1, y, border, a);
+    fillSpan<Clip, Mode>(x, x + w - 1, y + h - 1, border, a);
+    for (int i = 1; i < h - 1; i++) {
+        fillSpan<Clip, Mode>(x, x, y + i, border, a);
+        fillSpan<Clip, Mode>(x + w - 1, x + w - 1, y + i, border, a);
+    }
 }
 
-void Renderer::drawTextCenteredWithShadow(int y, const std::string& text, int r, int g, int b, int scale) {
-    int textWidth = text.length() * (8 * scale + scale);
-    int x = (screenWidth - textWidth) / 2;
-    drawTextWithShadow(x, y, text, r, g, b, scale);
+template <ClipMode Clip>
+void Renderer::fillCircle(int cx, int cy, int radius, int r, int g, int b) {
+    // Walk the rows outward from the centre. The half-width only ever
+    // shrinks, so each row's extent is found incrementally and the row
+    // (plus its mirror) goes out as a single span.
+    int rr = radius * radius;
+    int half = radius;
+    for (int y = 0; y <= radius; y++) {
+        while (half * half + y * y > rr) half--;
+        plotter.plotSpan<Clip>(cx - half, cx + half, cy + y, r, g, b);
+        if (y != 0) {
+            plotter.plotSpan<Clip>(cx - half, cx + half, cy - y, r, g, b);
+        }
+    }
 }
 
-void Renderer::drawGradientRect(int x, int y, int w, int h, int r1, int g1, int b1, int r2, int g2, int b2) {
-    for (int py = 0; py < h; py++) {
-        float ratio = (float)py / h;
-        int r = r1 + (int)((r2 - r1) * ratio);
-        int g = g1 + (int)((g2 - g1) * ratio);
-        int b = b1 + (int)((b2 - b1) * ratio);
+template <ClipMode Clip>
+void Renderer::fillCircleAA(int cx, int cy, int radius, int r, int g, int b) {
+    // Pixels whose centre lies within radius - 0.5 are fully covered and
+    // filled as a span; the one or two pixels past that on each side get
+    // coverage from their distance to the true edge at radius + 0.5.
+    float outer = radius + 0.5f;
+    float inner = radius - 0.5f;
+    for (int y = -radius - 1; y <= radius + 1; y++) {
+        float yy = (float)(y * y);
+        if (yy >= outer * outer) continue;
+
+        int solid = -1;
+        if (yy <= inner * inner) {
+            solid = (int)std::sqrt(inner * inner - yy);
+            plotter.plotSpan<Clip>(cx - solid, cx + solid, cy + y, r, g, b);
+        }
 
-        for (int px = 0; px < w; px++) {
-            if (x + px >= 0 && x + px < screenWidth && y + py >= 0 && y + py < screenHeight) {
-                plotter.plotPixel(x + px, y + py, r, g, b);
-            }
+        int edge = (int)std::ceil(std::sqrt(outer * outer - yy));
+        for (int x = solid + 1; x <= edge; x++) {
+            float coverage = outer - std::sqrt(x * x + yy);
+            if (coverage <= 0) break;
+            if (coverage > 1) coverage = 1;
+            int a = (int)(coverage * 255);
+            plotter.blendPixel<Clip>(cx - x, cy + y, r, g, b, a);
+            if (x != 0) plotter.blendPixel<Clip>(cx + x, cy + y, r, g, b, a);
         }
     }
 }
 
-void Renderer::drawCircle(int cx, int cy, int radius, int r, int g, int b) {
-    for (int y = -radius; y <= radius; y++) {
-        for (int x = -radius; x <= radius; x++) {
-            if (x * x + y * y <= radius * radius) {
-                int px = cx + x;
-                int py = cy + y;
-                if (px >= 0 && px < screenWidth && py >= 0 && py < screenHeight) {
-                    plotter.plotPixel(px, py, r, g, b);
+template void Renderer::drawString<ClipMode::Clipped, BlendMode::Opaque>(int, int, std::string_view, int, int, int, int, int);
+template void Renderer::drawString<ClipMode::Clipped, BlendMode::Alpha>(int, int, std::string_view, int, int, int, int, int);
+template void Renderer::drawString<ClipMode::Unclipped, BlendMode::Opaque>(int, int, std::string_view, int, int, int, int, int);
+template void Renderer::drawString<ClipMode::Unclipped, BlendMode::Alpha>(int, int, std::string_view, int, int, int, int, int);
+template void Renderer::fillGradient<ClipMode::Clipped, BlendMode::Opaque>(int, int, int, int, int, int, int, int, int, int, int);
+template void Renderer::fillGradient<ClipMode::Clipped, BlendMode::Alpha>(int, int, int, int, int, int, int, int, int, int, int);
+template void Renderer::fillGradient<ClipMode::Unclipped, BlendMode::Opaque>(int, int, int, int, int, int, int, int, int, int, int);
+template void Renderer::fillGradient<ClipMode::Unclipped, BlendMode::Alpha>(int, int, int, int, int, int, int, int, int, int, int);
+template void Renderer::fillBox<ClipMode::Clipped, BlendMode::Opaque>(int, int, int, int, int, int, int, int);
+template void Renderer::fillBox<ClipMode::Clipped, BlendMode::Alpha>(int, int, int, int, int, int, int, int);
+template void Renderer::fillBox<ClipMode::Unclipped, BlendMode::Opaque>(int, int, int, int, int, int, int, int);
+template void Renderer::fillBox<ClipMode::Unclipped, BlendMode::Alpha>(int, int, int, int, int, int, int, int);
+template void Renderer::fillCircle<ClipMode::Clipped>(int, int, int, int, int, int);
+template void Renderer::fillCircle<ClipMode::Unclipped>(int, int, int, int, int, int);
+template void Renderer::fillCircleAA<ClipMode::Clipped>(int, int, int, int, int, int);
+template void Renderer::fillCircleAA<ClipMode::Unclipped>(int, int, int, int, int, int);
+
+void Renderer::drawChar(int x, int y, char c, int r, int g, int b, int scale, int a) {
+    withModes(plotter, x, y, 5 * scale, 7 * scale, a, [&](auto clip, auto mode) {
+        drawGlyph<decltype(clip)::value, decltype(mode)::value>(x, y, c, packColor(r, g, b), scale, a);
+    });
+}
+
+const TextSpan* Renderer::rasterizeText(std::string_view text, int scale, int& count) {
+    // A row of five pixels holds at most three runs
+    TextSpan* spans = arena.allocateArray<TextSpan>(text.length() * FONT_GLYPH_HEIGHT * 3 * scale);
+    count = 0;
+    if (spans == nullptr) return nullptr;
+
+    int originX = 0;
+    for (char c : text) {
+        unsigned char code = static_cast<unsigned char>(c);
+        if (code < FONT_GLYPH_COUNT) {
+            const Glyph& glyph = FONT_5X7[code];
+            for (int row = 0; row < FONT_GLYPH_HEIGHT; row++) {
+                int col = 0;
+                while (col < FONT_GLYPH_WIDTH) {
+                    if (!(glyph.rows[row] & (0x80 >> col))) {
+                        col++;
+                        continue;
+                    }
+                    int start = col;
+                    while (col < FONT_GLYPH_WIDTH && (glyph.rows[row] & (0x80 >> col))) col++;
+                    for (int sy = 0; sy < scale; sy++) {
+                        spans[count].x0 = originX + start * scale;
+                        spans[count].x1 = originX + col * scale - 1;
+                        spans[count].y = row * scale + sy;
+                        count++;
+                    }
                 }
             }
         }
+        originX += 8 * scale + scale;
     }
+    return spans;
 }
 
-void Renderer::drawBox(int x, int y, int w, int h, int r, int g, int b) {
-    drawGradientRect(x, y, w, h, r, g, b, r - 10, g - 10, b - 10);
-
-    for (int i = 0; i < w; i++) {
-        plotter.plotPixel(x + i, y, 200, 200, 150);
-        plotter.plotPixel(x + i, y + h - 1, 200, 200, 150);
-    }
-    for (int i = 0; i < h; i++) {
-        plotter.plotPixel(x, y + i, 200, 200, 150);
-        plotter.plotPixel(x + w - 1, y + i, 200, 200, 150);
+void Renderer::drawTextRuns(int x, int y, std::string_view text, int r, int g, int b, int scale, int a, bool shadow) {
+    size_t scratch = arena.mark();
+    int count = 0;
+    const TextSpan* spans = rasterizeText(text, scale, count);
+
+    auto draw = [&](int ox, int oy, int cr, int cg, int cb) {
+        withModes(plotter, ox, oy, textWidth(text.length(), scale), 7 * scale, a, [&](auto clip, auto mode) {
+            constexpr ClipMode Clip = decltype(clip)::value;
+            constexpr BlendMode Mode = decltype(mode)::value;
+            if (spans == nullptr) {
+                drawString<Clip, Mode>(ox, oy, text, cr, cg, cb, scale, a);
+                return;
+            }
+            Uint32 color = packColor(cr, cg, cb);
+            for (int i = 0; i < count; i++) {
+                fillSpan<Clip, Mode>(ox + spans[i].x0, ox + spans[i].x1, oy + spans[i].y, color, a);
+            }
+        });
+    };
+    if (shadow) {
+        draw(x + 2, y + 2, 0, 0, 0);
     }
+    draw(x, y, r, g, b);
+
+    arena.rewind(scratch);
+}
+
+void Renderer::drawText(int x, int y, std::string_view text, int r, int g, int b, int scale, int a) {
+    drawTextRuns(x, y, text, r, g, b, scale, a, false);
+}
+
+void Renderer::drawTextCentered(int y, std::string_view text, int r, int g, int b, int scale, int a) {
+    int x = (screenWidth - textWidth(text.length(), scale)) / 2;
+    drawText(x, y, text, r, g, b, scale, a);
+}
+
+void Renderer::drawTextWithShadow(int x, int y, std::string_view text, int r, int g, int b, int scale, int a) {
+    drawTextRuns(x, y, text, r, g, b, scale, a, true);
+}
+
+void Renderer::drawTextCenteredWithShadow(int y, std::string_view text, int r, int g, int b, int scale, int a) {
+    int x = (screenWidth - textWidth(text.length(), scale)) / 2;
+    drawTextWithShadow(x, y, text, r, g, b, scale, a);
+}
+
+void Renderer::drawGradientRect(int x, int y, int w, int h, int r1, int g1, int b1, int r2, int g2, int b2, int a) {
+    withModes(plotter, x, y, w, h, a, [&](auto clip, auto mode) {
+        fillGradient<decltype(clip)::value, decltype(mode)::value>(x, y, w, h, r1, g1, b1, r2, g2, b2, a);
+    });
+}
+
+void Renderer::drawCircle(int cx, int cy, int radius, int r, int g, int b) {
+    withClip(plotter, cx - radius, cy - radius, 2 * radius + 1, 2 * radius + 1, [&](auto clip) {
+        fillCircle<decltype(clip)::value>(cx, cy, radius, r, g, b);
+    });
+}
+
+void Renderer::drawCircleAA(int cx, int cy, int radius, int r, int g, int b) {
+    withClip(plotter, cx - radius - 1, cy - radius - 1, 2 * radius + 3, 2 * radius + 3, [&](auto clip) {
+        fillCircleAA<decltype(clip)::value>(cx, cy, radius, r, g, b);
+    });
+}
+
+void Renderer::drawBox(int x, int y, int w, int h, int r, int g, int b, int a) {
+    withModes(plotter, x, y, w, h, a, [&](auto clip, auto mode) {
+        fillBox<decltype(clip)::value, decltype(mode)::value>(x, y, w, h, r, g, b, a);
+    });
 }
 
 void Renderer::drawBuilding(int x, int y, int w, int h, int r, int g, int b) {
@@ -104,7 +318,8 @@ void Renderer::drawBuilding(int x, int y, int w, int h, int r, int g, int b) {
 
     for (int wy = y + 10; wy < y + h - 10; wy += 25) {
         for (int wx = x + 10; wx < x + w - 10; wx += 20) {
-            bool lit = (rand() % 3 != 0);
+            flickerState = flickerState * 1664525u + 1013904223u;
+            bool lit = ((flickerState >> 16) % 3 != 0);
             int brightness = lit ? 255 : 50;
             drawGradientRect(wx, wy, 12, 15, brightness, brightness, 100,
                              brightness - 50, brightness - 50, 50);
@@ -113,82 +328,97 @@ void Renderer::drawBuilding(int x, int y, int w, int h, int r, int g, int b) {
 }
 
 void Renderer::drawTerrain(float bgScroll, float gameTime) {
-    for (int y = 0; y < 250; y++) {
-        float ratio = (float)y / 250;
-        int r = (int)(100 + ratio * 30 + sin(gameTime * 0.5f) * 10);
-        int g = (int)(180 + ratio * 40);
-        int b = (int)(255 - ratio * 50);
-
-        for (int x = 0; x < screenWidth; x++) {
-            plotter.plotPixel(x, y, r, g, b);
-        }
-    }
+    // Everything here spans the full width, so one check covers it all
+    withClip(plotter, 0, 0, screenWidth, screenHeight, [&](auto clip) {
+        constexpr ClipMode Clip = decltype(clip)::value;
 
-    int buildingOffset = (int)(bgScroll * 0.3f) % 200;
-    drawBuilding(50 - buildingOffset, 80, 120, 150, 40, 50, 70);
-    drawBuilding(250 - buildingOffset, 120, 100, 100, 35, 45, 65);
-    drawBuilding(500 - buildingOffset, 70, 140, 180, 45, 55, 75);
-    drawBuilding(750 - buildingOffset, 100, 130, 140, 38, 48, 68);
-    drawBuilding(950 - buildingOffset, 90, 110, 160, 42, 52, 72);
+        for (int y = 0; y < HORIZON_Y; y++) {
+            float ratio = (float)y / HORIZON_Y;
+            int r = (int)(100 + ratio * 30 + sin(gameTime * 0.5f) * 10);
+            int g = (int)(180 + ratio * 40);
+            int b = (int)(255 - ratio * 50);
 
-    drawGradientRect(0, 250, screenWidth, screenHeight - 250, 60, 65, 80, 90, 95, 120);
+            fillSpan<Clip, BlendMode::Opaque>(0, screenWidth - 1, y, packColor(r, g, b), 255);
+        }
 
-    int lineOffset = (int)bgScroll % 100;
-    for (int y = 250 + lineOffset; y < screenHeight; y += 100) {
-        for (int x = 0; x < screenWidth; x++) {
-            if (x % 20 < 10) {
-                plotter.plotPixel(x, y, 150, 150, 50);
+        int buildingOffset = (int)(bgScroll * 0.3f) % 200;
+        drawBuilding(50 - buildingOffset, 80, 120, 150, 40, 50, 70);
+        drawBuilding(250 - buildingOffset, 120, 100, 100, 35, 45, 65);
+        drawBuilding(500 - buildingOffset, 70, 140, 180, 45, 55, 75);
+        drawBuilding(750 - buildingOffset, 100, 130, 140, 38, 48, 68);
+        drawBuilding(950 - buildingOffset, 90, 110, 160, 42, 52, 72);
+
+        fillGradient<Clip, BlendMode::Opaque>(0, HORIZON_Y, screenWidth, screenHeight - HORIZON_Y,
+                                              60, 65, 80, 90, 95, 120, 255);
+
+        constexpr Uint32 dash = packColor(150, 150, 50);
+        int lineOffset = (int)bgScroll % 100;
+        for (int y = HORIZON_Y + lineOffset; y < screenHeight; y += 100) {
+            for (int x = 0; x < screenWidth; x += 20) {
+                fillSpan<Clip, BlendMode::Opaque>(x, std::min(x + 9, screenWidth - 1), y, dash, 255);
             }
         }
-    }
 
-    int laneX[] = {225, 475, 725};
-    for (int lx : laneX) {
-        for (int y = 250; y < screenHeight; y++) {
-            plotter.plotPixel(lx - 1, y, 150, 150, 70);
-            plotter.plotPixel(lx, y, 220, 220, 120);
-            plotter.plotPixel(lx + 1, y, 150, 150, 70);
+        constexpr Uint32 railEdge = packColor(150, 150, 70);
+        constexpr Uint32 railTop = packColor(220, 220, 120);
+        for (int lx : LANE_POSITIONS) {
+            for (int y = HORIZON_Y; y < screenHeight; y++) {
+                fillSpan<Clip, BlendMode::Opaque>(lx - 1, lx - 1, y, railEdge, 255);
+                fillSpan<Clip, BlendMode::Opaque>(lx, lx, y, railTop, 255);
+                fillSpan<Clip, BlendMode::Opaque>(lx + 1, lx + 1, y, railEdge, 255);
+            }
         }
-    }
+    });
 }
 
 void Renderer::drawPlayer(int currentLane, float playerY, float animTime) {
-    int targetX = 250 + currentLane * 250;
+    int targetX = LANE_TRACK_X[currentLane];
     int playerX = targetX;
     int py = (int)playerY;
-
-    int shadowY = 520;
-    float shadowScale = 1.0f - (520 - py) / 200.0f;
-    if (shadowScale > 0) {
-        for (int sy = 0; sy < 8 * shadowScale; sy++) {
-            for (int sx = -20 * shadowScale; sx < 20 * shadowScale; sx++) {
-                plotter.plotPixel(playerX + 20 + sx, shadowY + sy, 0, 0, 0);
+    int shadowY = PLAYER_Y_GROUND + PLAYER_HITBOX_HEIGHT;
+
+    // Bounding box of the whole figure: arms to either side, head above,
+    // legs (or the shadow, mid-jump) below
+    int top = py - 34;
+    int bottom = std::max(shadowY + 8, py + PLAYER_HEIGHT + 30);
+    withClip(plotter, playerX - 5, top, PLAYER_WIDTH + 11, bottom - top + 1, [&](auto clip) {
+        constexpr ClipMode Clip = decltype(clip)::value;
+
+        float shadowScale = 1.0f - (shadowY - py) / 200.0f;
+        if (shadowScale > 0) {
+            int left = (int)(-20 * shadowScale);
+            int right = (int)std::ceil(20 * shadowScale) - 1;
+            for (int sy = 0; sy < 8 * shadowScale; sy++) {
+                fillSpan<Clip, BlendMode::Opaque>(playerX + 20 + left, playerX + 20 + right, shadowY + sy,
+                                                  packColor(0, 0, 0), 255);
             }
         }
-    }
 
-    drawGradientRect(playerX, py, 40, 50, 0, 220, 255, 0, 150, 200);
-    drawCircle(playerX + 20, py - 15, 18, 255, 180, 100);
+        fillGradient<Clip, BlendMode::Opaque>(playerX, py, PLAYER_WIDTH, PLAYER_HEIGHT, 0, 220, 255, 0, 150, 200, 255);
+        fillCircleAA<Clip>(playerX + 20, py - 15, 18, 255, 180, 100);
 
-    int eyeOffset = (int)(sin(animTime * 8) * 2);
-    drawCircle(playerX + 12, py - 15 + eyeOffset, 3, 0, 0, 0);
-    drawCircle(playerX + 28, py - 15 + eyeOffset, 3, 0, 0, 0);
+        int eyeOffset = (int)(sin(animTime * 8) * 2);
+        fillCircle<Clip>(playerX + 12, py - 15 + eyeOffset, 3, 0, 0, 0);
+        fillCircle<Clip>(playerX + 28, py - 15 + eyeOffset, 3, 0, 0, 0);
 
-    for (int i = -5; i <= 5; i++) {
-        int smileY = py - 8 + abs(i) / 3;
-        plotter.plotPixel(playerX + 20 + i, smileY, 0, 0, 0);
-    }
+        for (int i = -5; i <= 5; i++) {
+            int smileY = py - 8 + abs(i) / 3;
+            fillSpan<Clip, BlendMode::Opaque>(playerX + 20 + i, playerX + 20 + i, smileY, packColor(0, 0, 0), 255);
+        }
 
-    int legAnim = (int)(sin(animTime * 15) * 10);
-    drawGradientRect(playerX + 8, py + 50, 10, 20 + abs(legAnim), 100, 50, 150, 80, 30, 120);
-    drawGradientRect(playerX + 22, py + 50, 10, 20 + abs(-legAnim), 100, 50, 150, 80, 30, 120);
+        int legAnim = (int)(sin(animTime * 15) * 10);
+        fillGradient<Clip, BlendMode::Opaque>(playerX + 8, py + PLAYER_HEIGHT, 10, 20 + abs(legAnim),
+                                              100, 50, 150, 80, 30, 120, 255);
+        fillGradient<Clip, BlendMode::Opaque>(playerX + 22, py + PLAYER_HEIGHT, 10, 20 + abs(-legAnim),
+                                              100, 50, 150, 80, 30, 120, 255);
 
-    int armAnim = (int)(sin(animTime * 15) * 8);
-    drawGradientRect(playerX - 5, py + 10 + armAnim, 8, 25, 0, 200, 230, 0, 150, 180);
-    drawGradientRect(playerX + 37, py + 10 - armAnim, 8, 25, 0, 200, 230, 0, 150, 180);
+        int armAnim = (int)(sin(animTime * 15) * 8);
+        fillGradient<Clip, BlendMode::Opaque>(playerX - 5, py + 10 + armAnim, 8, 25, 0, 200, 230, 0, 150, 180, 255);
+        fillGradient<Clip, BlendMode::Opaque>(playerX + 37, py + 10 - armAnim, 8, 25, 0, 200, 230, 0, 150, 180, 255);
+    });
 }
 
-void Renderer::drawObstacles(const std::vector<Obstacle>& obstacles) {
+void Renderer::drawObstacles(std::span<const Obstacle> obstacles) {
     for (const auto& obs : obstacles) {
         if (!obs.active) continue;
 
@@ -213,13 +443,11 @@ void Renderer::drawObstacles(const std::vector<Obstacle>& obstacles) {
             drawGradientRect(x, y, w, h, 100, 200, 100, 60, 150, 60);
         }
 
-        for (int i = 0; i < w; i++) {
-            plotter.plotPixel(x + i, y + 2, 255, 255, 255);
-        }
+        plotter.plotSpan(x, x + w - 1, y + 2, 255, 255, 255);
     }
 }
 
-void Renderer::drawCollectibles(const std::vector<Collectible>& collectibles) {
+void Renderer::drawCollectibles(std::span<const Collectible> collectibles) {
     for (const auto& col : collectibles) {
         if (!col.active) continue;
 
@@ -228,11 +456,11 @@ void Renderer::drawCollectibles(const std::vector<Collectible>& collectibles) {
 
         if (y < -50 || y > screenHeight + 50) continue;
 
-        float bounce = sin(col.animTime * 8) * 5;
+        float bounce = sin((float)col.animTime * 8) * 5;
         int cy = y + (int)bounce;
 
         if (col.type == 0) {
-            drawCircle(x, cy, 15, 255, 215, 0);
+            drawCircleAA(x, cy, 15, 255, 215, 0);
             drawCircle(x, cy, 10, 255, 255, 100);
             drawCircle(x, cy, 5, 255, 255, 200);
         } else {
@@ -240,15 +468,13 @@ void Renderer::drawCollectibles(const std::vector<Collectible>& collectibles) {
             drawCircle(x + 8, cy - 5, 8, 255, 50, 100);
             for (int dy = 0; dy < 15; dy++) {
                 int width = 16 - dy;
-                for (int dx = -width / 2; dx < width / 2; dx++) {
-                    plotter.plotPixel(x + dx, cy + dy, 255, 50, 100);
-                }
+                plotter.plotSpan(x - width / 2, x + width / 2 - 1, cy + dy, 255, 50, 100);
             }
         }
     }
 }
 
-void Renderer::drawParticles(const std::vector<Particle>& particles) {
+void Renderer::drawParticles(std::span<const Particle> particles) {
     for (const auto& p : particles) {
         if (p.life <= 0) continue;
 
@@ -257,61 +483,65 @@ void Renderer::drawParticles(const std::vector<Particle>& particles) {
 
         if (x < 0 || x >= screenWidth || y < 0 || y >= screenHeight) continue;
 
-        float alpha = p.life / p.maxLife;
-        int r = (int)(p.r * alpha);
-        int g = (int)(p.g * alpha);
-        int b = (int)(p.b * alpha);
-
-        for (int dy = 0; dy < p.size; dy++) {
-            for (int dx = 0; dx < p.size; dx++) {
-                plotter.plotPixel(x + dx, y + dy, r, g, b);
+        int alpha = (int)(255 * p.life / p.maxLife);
+        withModes(plotter, x, y, p.size, p.size, alpha, [&](auto clip, auto mode) {
+            Uint32 color = packColor(p.r, p.g, p.b);
+            for (int dy = 0; dy < p.size; dy++) {
+                fillSpan<decltype(clip)::value, decltype(mode)::value>(x, x + p.size - 1, y + dy, color, alpha);
             }
-        }
+        });
     }
 }
 
 void Renderer::drawHUD(int score, int lives, int level, int comboMultiplier, float comboTimer,
                        bool showInstructions, float instructionTimer, int gameState) {
-    drawBox(10, 10, 200, 60, 30, 40, 60);
+    drawBox(10, 10, 200, 60, 30, 40, 60, HUD_ALPHA);
     drawTextWithShadow(20, 20, "SCORE", 255, 200, 100, 1);
-    drawTextWithShadow(20, 35, std::to_string(score), 255, 255, 150, 2);
+    drawTextWithShadow(20, 35, arena.format("", score), 255, 255, 150, 2);
 
-    drawBox(350, 10, 200, 60, 30, 40, 60);
+    drawBox(350, 10, 200, 60, 30, 40, 60, HUD_ALPHA);
     drawTextWithShadow(360, 25, "LIVES:", 255, 100, 100, 1);
     for (int i = 0; i < lives; i++) {
         drawCircle(440 + i * 30, 40, 8, 255, 50, 100);
     }
 
-    drawBox(690, 10, 200, 60, 30, 40, 60);
+    drawBox(690, 10, 200, 60, 30, 40, 60, HUD_ALPHA);
     drawTextWithShadow(700, 20, "LEVEL", 100, 200, 255, 1);
-    drawTextWithShadow(700, 35, std::to_string(level), 150, 220, 255, 2);
+    drawTextWithShadow(700, 35, arena.format("", level), 150, 220, 255, 2);
 
     if (comboMultiplier > 1 && comboTimer > 0) {
         int comboY = 80;
-        drawBox(350, comboY, 220, 40, 50, 20, 70);
-        drawTextWithShadow(365, comboY + 10, "COMBO x" + std::to_string(comboMultiplier),
+        drawBox(350, comboY, 220, 40, 50, 20, 70, HUD_ALPHA);
+        drawTextWithShadow(365, comboY + 10, arena.format("COMBO x", comboMultiplier),
                            255, 100, 255, 2);
     }
 
-    if (showInstructions && gameState == 1 && instructionTimer < 8.0f) {
+    if (showInstructions && gameState == 1 && instructionTimer < INSTRUCTION_SECONDS) {
         int alpha = 255;
         if (instructionTimer > 6.0f) {
             alpha = (int)(255 * (1.0f - (instructionTimer - 6.0f) / 2.0f));
         }
 
-        drawBox(150, 140, 700, 120, 20, 20, 40);
-        int r = (255 * alpha) / 255;
-        int g = (200 * alpha) / 255;
-        int b = (100 * alpha) / 255;
+        drawBox(150, 140, 700, 120, 20, 20, 40, HUD_ALPHA * alpha / 255);
 
-        drawTextCenteredWithShadow(155, "CONTROLS", r, g, b, 2);
-        drawTextCenteredWithShadow(185, "A/LEFT - MOVE LEFT", r - 50, g - 50, b + 100, 1);
-        drawTextCenteredWithShadow(205, "D/RIGHT - MOVE RIGHT", r - 50, g - 50, b + 100, 1);
-        drawTextCenteredWithShadow(225, "W/UP/SPACE - JUMP", r - 50, g - 50, b + 100, 1);
-        drawTextCenteredWithShadow(245, "P - PAUSE", r - 50, g - 50, b + 100, 1);
+        drawTextCenteredWithShadow(155, "CONTROLS", 255, 200, 100, 2, alpha);
+        drawTextCenteredWithShadow(185, "A/LEFT - MOVE LEFT", 205, 150, 200, 1, alpha);
+        drawTextCenteredWithShadow(205, "D/RIGHT - MOVE RIGHT", 205, 150, 200, 1, alpha);
+        drawTextCenteredWithShadow(225, "W/UP/SPACE - JUMP", 205, 150, 200, 1, alpha);
+        drawTextCenteredWithShadow(245, "P - PAUSE", 205, 150, 200, 1, alpha);
     }
 }
 
+void Renderer::drawGameState(const GameState& s) {
+    drawTerrain((float)s.bgScroll, (float)s.gameTime);
+    drawObstacles({s.obstacles, (size_t)s.obstacleCount});
+    drawCollectibles({s.collectibles, (size_t)s.collectibleCount});
+    drawPlayer(s.currentLane, (float)s.playerY, (float)s.animTime);
+    drawParticles({s.particles, (size_t)s.particleCount});
+    drawHUD(s.score, s.lives, s.level, s.comboMultiplier, (float)s.comboTimer, s.showInstructions,
+            (float)s.instructionTimer, s.gameState);
+}
+
 void Renderer::drawStartScreen() {
     drawTerrain(0, 0);
 
@@ -332,24 +562,64 @@ void Renderer::drawStartScreen() {
 }
 
 void Renderer::drawGameOverScreen(int score, int level) {
-    drawBox(100, 150, 800, 300, 50, 30, 80);
+    drawGradientRect(0, 0, screenWidth, screenHeight, 0, 0, 0, 0, 0, 0, OVERLAY_DIM_ALPHA);
+    drawBox(100, 150, 800, 300, 50, 30, 80, OVERLAY_ALPHA);
     drawTextCenteredWithShadow(180, "GAME OVER!", 255, 100, 50, 3);
-    drawTextCenteredWithShadow(250, "FINAL SCORE: " + std::to_string(score), 255, 200, 100, 2);
-    drawTextCenteredWithShadow(290, "LEVEL REACHED: " + std::to_string(level), 100, 200, 255, 2);
+    drawTextCenteredWithShadow(250, arena.format("FINAL SCORE: ", score), 255, 200, 100, 2);
+    drawTextCenteredWithShadow(290, arena.format("LEVEL REACHED: ", level), 100, 200, 255, 2);
     drawTextCenteredWithShadow(350, "PRESS R TO RESTART", 100, 255, 100, 2);
     drawTextCenteredWithShadow(385, "PRESS Q TO QUIT", 200, 200, 255, 1);
 }
 
 void Renderer::drawPauseScreen() {
-    for (int y = 200; y < 400; y++) {
-        for (int x = 250; x < 750; x++) {
-            if ((x + y) % 4 == 0) {
-                plotter.plotPixel(x, y, 0, 0, 0);
-            }
-        }
-    }
-    drawBox(250, 200, 500, 200, 40, 30, 70);
+    drawGradientRect(0, 0, screenWidth, screenHeight, 0, 0, 0, 0, 0, 0, OVERLAY_DIM_ALPHA);
+    drawBox(250, 200, 500, 200, 40, 30, 70, OVERLAY_ALPHA);
     drawTextCenteredWithShadow(230, "PAUSED", 100, 200, 255, 3);
     drawTextCenteredWithShadow(300, "PRESS P TO RESUME", 200, 200, 255, 2);
     drawTextCenteredWithShadow(340, "PRESS Q TO QUIT", 150, 150, 200, 1);
-}
\ No newline at end of file
+}
+
+void Renderer::drawRewindIndicator() {
+    drawBox(screenWidth / 2 - 90, 70, 180, 40, 40, 30, 70, OVERLAY_ALPHA);
+    drawTextCenteredWithShadow(82, "<< REWIND", 100, 200, 255, 2);
+}
+
+void Renderer::drawTelemetry(const Telemetry& telemetry) {
+    const int x = 690, top = 80, lineHeight = 14;
+    int y = top + 10;
+    // Allocation lines, the peak fill header and containers, then RSS
+    int lines = (allocationCountingEnabled() ? 2 + SUBSYSTEM_COUNT : 1) + 1 + CONTAINER_COUNT + 1;
+    drawBox(x, top, 200, 20 + lines * lineHeight, 20, 20, 30, OVERLAY_ALPHA);
+
+    if (allocationCountingEnabled()) {
+        AllocationCount frame = telemetry.getFrameAllocations();
+        drawText(x + 10, y, arena.format("allocs/frame ", frame.count), 255, 220, 120, 1);
+        y += lineHeight;
+        drawText(x + 10, y, arena.format("bytes/frame ", frame.bytes), 255, 220, 120, 1);
+        y += lineHeight;
+        for (int s = 0; s < SUBSYSTEM_COUNT; s++) {
+            Subsystem subsystem = static_cast<Subsystem>(s);
+            drawText(x + 20, y, subsystemName(subsystem), 200, 200, 200, 1);
+            drawText(x + 140, y, arena.format("", telemetry.getFrameAllocations(subsystem).count),
+                     200, 200, 200, 1);
+            y += lineHeight;
+        }
+    } else {
+        drawText(x + 10, y, "alloc counting off", 160, 160, 160, 1);
+        y += lineHeight;
+    }
+
+    drawText(x + 10, y, "peak fill", 255, 220, 120, 1);
+    y += lineHeight;
+    for (int c = 0; c < CONTAINER_COUNT; c++) {
+        const ContainerStat& stat = telemetry.getContainer(static_cast<Container>(c));
+        drawText(x + 20, y, containerName(static_cast<Container>(c)), 150, 220, 255, 1);
+        drawText(x + 140, y, arena.format("", stat.highWater), 150, 220, 255, 1);
+        y += lineHeight;
+    }
+    drawText(x + 10, y, arena.format("rss kb ", telemetry.getRss() / 1024), 150, 255, 150, 1);
+}
+
+void Renderer::sampleTelemetry(Telemetry& telemetry) const {
+    telemetry.sampleContainer(Container::FrameArena, arena.mark(), RENDER_ARENA_BYTES);
+}
@@ -1,61 +1,160 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
-#include <string>
-#include <vector>
+#include <span>
+#include <string_view>
 
+#include "FrameArena.h"
 #include "GameObjects.h"
+#include "GameState.h"
 #include "SDL_Plotter.h"
+#include "Telemetry.h"
+
+// One run of set pixels in rasterized text, relative to the text origin
+struct TextSpan {
+    int x0, x1, y;
+};
 
 class Renderer {
    private:
     SDL_Plotter& plotter;
     int screenWidth;
     int screenHeight;
+    // Window flicker uses its own generator so that drawing never moves
+    // the simulation's rand() sequence, which replays depend on
+    Uint32 flickerState;
+    // Transient per-frame data: formatted numbers and text scratch
+    FrameArena arena;
+
+    // description: fills the pixels x0..x1 on row y in the given modes
+    // return: void
+    // precondition: color packed (see packColor); a between 0 and 255
+    //               (ignored when Opaque); the span in the framebuffer
+    //               when Unclipped
+    // postcondition: span stored or blended
+    template <ClipMode Clip, BlendMode Mode>
+    void fillSpan(int x0, int x1, int y, Uint32 color, int a);
+    // description: draws one glyph in the given modes
+    // return: void
+    // precondition: as drawChar, with the color packed; the glyph cell in
+    //               the framebuffer when Unclipped
+    // postcondition: glyph drawn
+    template <ClipMode Clip, BlendMode Mode>
+    void drawGlyph(int x, int y, char c, Uint32 color, int scale, int a);
+    // description: turns text into runs of set pixels, one per glyph row
+    //              run and scaled row, in the frame arena
+    // return: const TextSpan* (the runs, or nullptr if the arena is full)
+    // precondition: caller rewinds the arena when done with the runs
+    // postcondition: count holds the number of runs
+    const TextSpan* rasterizeText(std::string_view text, int scale, int& count);
+    // description: draws text, and optionally its shadow, from one
+    //              rasterization
+    // return: void
+    // precondition: as drawText
+    // postcondition: shadow (if asked) then text drawn; arena unchanged
+    void drawTextRuns(int x, int y, std::string_view text, int r, int g, int b, int scale, int a, bool shadow);
 
    public:
     Renderer(SDL_Plotter& g, int w, int h);
+
+    // description: starts a frame, freeing the last frame's transient data
+    // return: void
+    // precondition: nothing from the last frame is still in use
+    // postcondition: frame arena empty
+    void beginFrame();
+
+    // Primitives with their clip and blend modes fixed at compile time.
+    // The draw functions below check the bounding box and opacity once
+    // and call these; a caller that already knows its shape is in the
+    // framebuffer (on screen or in the guard band, see
+    // SDL_Plotter::contains) can call the Unclipped instantiation
+    // directly.
+
+    // description: draws a string in the given modes
+    // return: void
+    // precondition: as drawText; the whole string in the framebuffer when
+    //               Unclipped
+    // postcondition: text drawn
+    template <ClipMode Clip, BlendMode Mode>
+    void drawString(int x, int y, std::string_view text, int r, int g, int b, int scale, int a);
+    // description: draws a vertical gradient in the given modes
+    // return: void
+    // precondition: as drawGradientRect; the rectangle in the framebuffer
+    //               when Unclipped
+    // postcondition: gradient drawn
+    template <ClipMode Clip, BlendMode Mode>
+    void fillGradient(int x, int y, int w, int h, int r1, int g1, int b1, int r2, int g2, int b2, int a);
+    // description: draws a box and its border in the given modes
+    // return: void
+    // precondition: as drawBox; the box in the framebuffer when Unclipped
+    // postcondition: box drawn
+    template <ClipMode Clip, BlendMode Mode>
+    void fillBox(int x, int y, int w, int h, int r, int g, int b, int a);
+    // description: draws a solid circle in the given clip mode
+    // return: void
+    // precondition: radius > 0; the circle's bounding square in the
+    //               framebuffer when Unclipped
+    // postcondition: circle drawn
+    template <ClipMode Clip>
+    void fillCircle(int cx, int cy, int radius, int r, int g, int b);
+    // description: draws an anti-aliased circle in the given clip mode
+    // return: void
+    // precondition: radius > 0; the square of side 2 * radius + 3 around
+    //               the centre in the framebuffer when Unclipped
+    // postcondition: circle drawn with a blended edge
+    template <ClipMode Clip>
+    void fillCircleAA(int cx, int cy, int radius, int r, int g, int b);
+
     // description: The functin draws a  character at (x,y).
+    //              a is the opacity used by all the text functions.
     // return: void
-    // precondition: Valid screen coordinates.
+    // precondition: Valid screen coordinates; a between 0 and 255.
     // postcondition: Character is drawn to screen.
-    void drawChar(int x, int y, char c, int r, int g, int b, int scale = 1);
+    void drawChar(int x, int y, char c, int r, int g, int b, int scale = 1, int a = 255);
     // description: The function draws text starting at (x,y).
     // return: void
     // precondition: Valid string and coordinates.
     // postcondition: Text appears on screen.
-    void drawText(int x, int y, const std::string& text, int r, int g, int b, int scale = 1);
+    void drawText(int x, int y, std::string_view text, int r, int g, int b, int scale = 1, int a = 255);
     // description: The function draws horizontally centered text at y.
     // return: void
     // precondition: Valid string; y inside screen.
     // postcondition: Centered text is rendered.
-    void drawTextCentered(int y, const std::string& text, int r, int g, int b, int scale = 1);
+    void drawTextCentered(int y, std::string_view text, int r, int g, int b, int scale = 1, int a = 255);
     // description: The function draws text with a shadow behind it.
     // return: void
     // precondition: Valid string and coords.
     // postcondition: Text with shadow appears on screen.
-    void drawTextWithShadow(int x, int y, const std::string& text, int r, int g, int b, int scale = 1);
+    void drawTextWithShadow(int x, int y, std::string_view text, int r, int g, int b, int scale = 1, int a = 255);
     // description: The function draws centered text with a shadow.
     // return: void 
     // precondition: Valid string; y within screen.
     // postcondition: Centered shadow text is rendered.
-    void drawTextCenteredWithShadow(int y, const std::string& text, int r, int g, int b, int scale = 1);
+    void drawTextCenteredWithShadow(int y, std::string_view text, int r, int g, int b, int scale = 1, int a = 255);
 
-    // description: Draws rectangle with gradient color.
+    // description: Draws rectangle with gradient color, blended with
+    //              opacity a.
     // return: void
-    // precondition: Positive width & height.
+    // precondition: Positive width & height; a between 0 and 255.
     // postcondition: Gradient rectangle is drawn.
-    void drawGradientRect(int x, int y, int w, int h, int r1, int g1, int b1, int r2, int g2, int b2);
+    void drawGradientRect(int x, int y, int w, int h, int r1, int g1, int b1, int r2, int g2, int b2,
+                          int a = 255);
     // description: Draws a circle at center (cx,cy).
     // return: void
     // precondition: radius > 0.
     // postcondition: Circle is drawn to screen.
     void drawCircle(int cx, int cy, int radius, int r, int g, int b);
+    // description: Draws an anti-aliased circle at center (cx,cy).
+    // return: void
+    // precondition: radius > 0.
+    // postcondition: Circle is drawn with its edge blended into the
+    //                pixels already on screen.
+    void drawCircleAA(int cx, int cy, int radius, int r, int g, int b);
     // description: Draws a filled rectangle (box).
     // return: void
     // precondition: w,h > 0.
     // postcondition: Box is drawn on screen.
-    void drawBox(int x, int y, int w, int h, int r, int g, int b);
+    void drawBox(int x, int y, int w, int h, int r, int g, int b, int a = 255);
 
     // description: Draws background terrain with scrolling.
     // return: void
@@ -75,25 +174,30 @@ class Renderer {
     void drawPlayer(int currentLane, float playerY, float animTime);
     // description: Draws all obstacles.
     // return: void
-    // precondition: obstacles vector initialized.
+    // precondition: obstacles initialized.
     // postcondition: Obstacles displayed.
-    void drawObstacles(const std::vector<Obstacle>& obstacles);
+    void drawObstacles(std::span<const Obstacle> obstacles);
     // description: Draws all collectibles.
     // return: void
-    // precondition: collectibles vector valid.
+    // precondition: collectibles valid.
     // postcondition: Collectibles rendered.
-    void drawCollectibles(const std::vector<Collectible>& collectibles);
+    void drawCollectibles(std::span<const Collectible> collectibles);
     // description: Draws particle effects.
     // return: void
-    // precondition: particles vector valid.
+    // precondition: particles valid.
     // postcondition: Particles rendered.
-    void drawParticles(const std::vector<Particle>& particles);
+    void drawParticles(std::span<const Particle> particles);
     // description: Draws HUD with score/life info.
     // return: void
     // precondition: Valid game state values.
     // postcondition: HUD rendered on screen.
     void drawHUD(int score, int lives, int level, int comboMultiplier, float comboTimer,
                  bool showInstructions, float instructionTimer, int gameState);
+    // description: Draws a game's playfield and HUD.
+    // return: void
+    // precondition: state is past the start screen.
+    // postcondition: Terrain, objects, player, particles and HUD drawn.
+    void drawGameState(const GameState& state);
     // description: Draws start screen UI.
     // return: void 
     // precondition: plotter active.
@@ -109,6 +213,21 @@ class Renderer {
     // precondition: plotter running.
     // postcondition: Pause screen shown.
     void drawPauseScreen();
+    // description: Draws the rewind banner shown while rewinding.
+    // return: void
+    // precondition: plotter running.
+    // postcondition: Rewind banner shown.
+    void drawRewindIndicator();
+    // description: Draws the memory telemetry overlay.
+    // return: void
+    // precondition: telemetry has seen at least one frame.
+    // postcondition: Allocations, container fill and RSS shown.
+    void drawTelemetry(const Telemetry& telemetry);
+    // description: Reports the frame arena's fill level.
+    // return: void
+    // precondition: called after the frame was drawn.
+    // postcondition: FrameArena container sampled.
+    void sampleTelemetry(Telemetry& telemetry) const;
 };
 
 #endif
@@ -0,0 +1,191 @@
+#include "Replay.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "GameObjects.h"
+
+// Bumped whenever the file layout or the meaning of a recorded tick changes
+const int REPLAY_VERSION = 4;
+
+// The number type the simulation ran on. A session recorded with one
+// plays out differently on the other; replays without the line are float.
+#ifdef SUBWAY_FIXED_POINT
+const std::string REPLAY_PHYSICS = "fixed";
+#else
+const std::string REPLAY_PHYSICS = "float";
+#endif
+
+Replay::Replay()
+    : playhead(0),
+      hashhead(0),
+      checkedTicks(0),
+      diverged(false),
+      expected(),
+      actual(),
+      seed(0),
+      length(0),
+      recordHashes(false) {}
+
+bool Replay::load(const std::string& path) {
+    std::ifstream file(path.c_str());
+    if (!file) {
+        std::cout << "Failed to open replay: " << path << std::endl;
+        return false;
+    }
+
+    events.clear();
+    hashes.clear();
+    playhead = 0;
+    hashhead = 0;
+    checkedTicks = 0;
+    diverged = false;
+    seed = 0;
+    length = 0;
+
+    int version = 0;
+    std::string physics = "float";
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++) {
+        std::istringstream in(line);
+        std::string word;
+        if (!(in >> word) || word[0] == '#') continue;
+
+        bool ok;
+        if (word == "replay") {
+            ok = (in >> version) && version == REPLAY_VERSION;
+        } else if (word == "physics") {
+            ok = (in >> physics) && (physics == "float" || physics == "fixed");
+        } else if (word == "seed") {
+            ok = (bool)(in >> seed);
+        } else if (word == "length") {
+            ok = (bool)(in >> length);
+        } else if (word == "event") {
+            ReplayEvent e;
+            int key;
+            ok = (in >> e.tick >> e.event.type >> key >> e.event.x >> e.event.y) &&
+                 (events.empty() || e.tick >= events.back().tick);
+            e.event.key = (char)key;
+            e.event.timestamp = 0;
+            if (ok) events.push_back(e);
+        } else if (word == "hash") {
+            ReplayHash h;
+            ok = (bool)(in >> h.tick >> std::hex);
+            for (uint32_t& field : h.hash.fields) {
+                ok = ok && (in >> field);
+            }
+            ok = ok && (hashes.empty() || h.tick > hashes.back().tick);
+            if (ok) hashes.push_back(h);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cout << path << ":" << lineNumber << ": bad replay line '" << line << "'" << std::endl;
+            return false;
+        }
+    }
+
+    if (version != REPLAY_VERSION) {
+        std::cout << "Replay Error: " << path << " is not a version " << REPLAY_VERSION << " replay" << std::endl;
+        return false;
+    }
+    if (physics != REPLAY_PHYSICS) {
+        std::cout << "Replay Warning: " << path << " was recorded with " << physics << " physics and this build uses "
+                  << REPLAY_PHYSICS << ", so it may play out differently" << std::endl;
+    }
+    return true;
+}
+
+bool Replay::save(const std::string& path) const {
+    std::ofstream file(path.c_str());
+    if (!file) {
+        std::cout << "Failed to write replay: " << path << std::endl;
+        return false;
+    }
+
+    file << "replay " << REPLAY_VERSION << "\n";
+    file << "physics " << REPLAY_PHYSICS << "\n";
+    file << "seed " << seed << "\n";
+    file << "length " << length << "\n";
+    for (const ReplayEvent& e : events) {
+        file << "event " << e.tick << " " << e.event.type << " " << (int)e.event.key << " "
+             << e.event.x << " " << e.event.y << "\n";
+    }
+    for (const ReplayHash& h : hashes) {
+        file << "hash " << std::dec << h.tick << std::hex << std::setfill('0');
+        for (uint32_t field : h.hash.fields) {
+            file << " " << std::setw(8) << field;
+        }
+        file << "\n";
+    }
+    return (bool)file;
+}
+
+void Replay::record(InputQueue& source, InputQueue& dest, Uint32 tick, Uint32 tickEnd) {
+    InputEvent e;
+    while (source.peek(e) && (Sint32)(e.timestamp - tickEnd) <= 0) {
+        source.pop(e);
+        ReplayEvent recorded;
+        recorded.tick = tick;
+        recorded.event = e;
+        events.push_back(recorded);
+        dest.push(e);
+    }
+    length = tick + 1;
+}
+
+void Replay::play(InputQueue& dest, Uint32 tick, Uint32 tickEnd) {
+    while (playhead < events.size() && events[playhead].tick <= tick) {
+        InputEvent e = events[playhead].event;
+        e.timestamp = tickEnd;
+        dest.push(e);
+        playhead++;
+    }
+}
+
+void Replay::checkTick(Uint32 tick, const GameState& state) {
+    if (recordHashes) {
+        hashes.push_back({tick, state.hash()});
+        return;
+    }
+    // Only the first divergence is kept: everything after it follows
+    // from it
+    if (diverged) return;
+    while (hashhead < hashes.size() && hashes[hashhead].tick < tick) {
+        hashhead++;
+    }
+    if (hashhead == hashes.size() || hashes[hashhead].tick != tick) return;
+
+    StateHash h = state.hash();
+    checkedTicks++;
+    if (h != hashes[hashhead].hash) {
+        diverged = true;
+        expected = hashes[hashhead];
+        actual = {tick, h};
+    }
+    hashhead++;
+}
+
+bool Replay::reportCheck(const std::string& path) const {
+    if (!diverged) {
+        std::cout << path << ": " << checkedTicks << " of " << hashes.size() << " recorded state hashes matched"
+                  << std::endl;
+        return true;
+    }
+
+    // Every field that differs, since one going wrong soon drags others
+    // along: the first tick usually shows which one started it
+    std::cout << "Replay Desync: " << path << " diverged at tick " << actual.tick << std::endl;
+    for (int f = 0; f < STATE_FIELD_COUNT; f++) {
+        if (expected.hash.fields[f] == actual.hash.fields[f]) continue;
+        char line[80];
+        std::snprintf(line, sizeof(line), "  %-13s recorded %08x, played %08x",
+                      stateFieldName(static_cast<StateField>(f)), expected.hash.fields[f], actual.hash.fields[f]);
+        std::cout << line << std::endl;
+    }
+    return false;
+}
@@ -0,0 +1,115 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+#include "InputQueue.h"
+
+// A recorded session: the random seed, how many ticks it ran and every
+// input event along with the tick that consumed it. The simulation only
+// depends on those, so feeding the events back on the same ticks (with
+// the same profile and physics) replays the session exactly, at any
+// speed. A recording can also keep the state hash after every tick, so a
+// replay proves it played out the same and finds the first tick where it
+// did not.
+//
+// Replays are plain text:
+//
+//   replay 4
+//   physics <float | fixed>   (optional, float if missing)
+//   seed <n>
+//   length <ticks>
+//   event <tick> <type> <key code> <x> <y>
+//   ...
+//   hash <tick> <one hex word per StateField>   (optional)
+//   ...
+struct ReplayEvent {
+    Uint32 tick;
+    InputEvent event;
+};
+
+// The state as it stood after a tick
+struct ReplayHash {
+    Uint32 tick;
+    StateHash hash;
+};
+
+class Replay {
+   private:
+    // Next event to hand out while playing
+    size_t playhead;
+
+    // Next recorded hash to check, and the first tick that failed one
+    size_t hashhead;
+    Uint32 checkedTicks;
+    bool diverged;
+    ReplayHash expected;
+    ReplayHash actual;
+
+   public:
+    unsigned seed;
+    Uint32 length;
+    std::vector<ReplayEvent> events;
+    std::vector<ReplayHash> hashes;
+
+    // Whether checkTick records hashes rather than checking them
+    bool recordHashes;
+
+    // description: makes an empty replay
+    // return: N/A (constructor)
+    // precondition: none
+    // postcondition: no events or hashes, zero length, seed 0
+    Replay();
+
+    // description: reads a replay file
+    // return: bool (true if the whole file was valid)
+    // precondition: path names a replay written by save
+    // postcondition: replay holds the file's seed, length, events and
+    //                hashes and is rewound; on failure the error is
+    //                printed
+    bool load(const std::string& path);
+
+    // description: writes the replay to a file
+    // return: bool (true if written)
+    // precondition: events and hashes are in tick order
+    // postcondition: file holds the replay; on failure the error is printed
+    bool save(const std::string& path) const;
+
+    // description: moves the events due this tick from the live queue to
+    //              the game's queue, recording each one
+    // return: void
+    // precondition: tickEnd is the SDL tick (ms) at which tick ends
+    // postcondition: events stamped at or before tickEnd moved to dest
+    //                in order and appended to events; length covers tick
+    void record(InputQueue& source, InputQueue& dest, Uint32 tick, Uint32 tickEnd);
+
+    // description: queues the events recorded for this tick
+    // return: void
+    // precondition: ticks are played in order starting from 0
+    // postcondition: this tick's events pushed to dest, stamped tickEnd
+    void play(InputQueue& dest, Uint32 tick, Uint32 tickEnd);
+
+    // description: records the state's hash after a tick, or compares it
+    //              with the one recorded for that tick. Costs nothing
+    //              when there is nothing to record or check.
+    // return: void
+    // precondition: called after each tick, in order, with the state it
+    //               left
+    // postcondition: with recordHashes the hash is appended to hashes;
+    //                otherwise the first tick whose hash differs is kept
+    //                for reportCheck
+    void checkTick(Uint32 tick, const GameState& state);
+
+    // description: prints how the ticks played compared with the recorded
+    //              hashes: the first tick that diverged and the fields
+    //              that differed, or how many ticks matched
+    // return: bool (false if a tick diverged)
+    // precondition: the replay has been played through checkTick
+    // postcondition: none
+    bool reportCheck(const std::string& path) const;
+};
+
+#endif
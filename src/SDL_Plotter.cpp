@@ -18,63 +18,219 @@
 
 #include "SDL_Plotter.h"
 
-// Threaded Sound Function
-
-static int Sound(void* data) {
-    param* p = (param*)data;
-    p->running = true;
-    Mix_Chunk* gScratch = NULL;
-    gScratch = Mix_LoadWAV(p->name.c_str());
-
-    while (p->running) {
-        SDL_mutexP(p->mut);
-        SDL_CondWait(p->cond, p->mut);
-        Mix_PlayChannel(-1, gScratch, 0);
-        p->play = false;
-        SDL_mutexV(p->mut);
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <cstdint>
+#include <new>
+
+#include "AllocationCounter.h"
+
+// Alpha Blending
+//
+// Every channel is mixed as (src * a + dst * (255 - a)) / 255, rounded.
+// The SSE2 loops work on four pixels at a time in 16-bit lanes and use
+// the same rounding as the scalar code, so both give identical results.
+
+static inline Uint32 blendChannel(Uint32 src, Uint32 dst, Uint32 a) {
+    Uint32 t = src * a + dst * (255 - a) + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+static inline Uint32 blendColor(Uint32 src, Uint32 dst, Uint32 a) {
+    return blendChannel((src >> 16) & 0xFF, (dst >> 16) & 0xFF, a) << 16 |
+           blendChannel((src >> 8) & 0xFF, (dst >> 8) & 0xFF, a) << 8 |
+           blendChannel(src & 0xFF, dst & 0xFF, a);
+}
+
+#if defined(__SSE2__)
+// (t + (t >> 8)) >> 8 on each 16-bit lane
+static inline __m128i divide255(__m128i t) {
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// Whether an SSE2 block can be loaded from or stored to p aligned
+static inline bool isAligned(const Uint32* p) {
+    return ((uintptr_t)p & (sizeof(__m128i) - 1)) == 0;
+}
+#endif
+
+static void blendRunConstant(Uint32* dst, int count, Uint32 color, Uint32 a) {
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i inverse = _mm_set1_epi16((short)(255 - a));
+    const __m128i source = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero),
+                        _mm_set1_epi16((short)a)),
+        _mm_set1_epi16(128));
+    const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+
+    // Pixels before the first 16-byte boundary go one at a time, so the
+    // loop below loads and stores aligned blocks; a run from a row's
+    // start has none
+    for (; i < count && !isAligned(dst + i); i++) {
+        dst[i] = blendColor(color, dst[i], a);
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_load_si128((const __m128i*)(dst + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inverse), source);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inverse), source);
+        __m128i out = _mm_packus_epi16(divide255(lo), divide255(hi));
+        _mm_store_si128((__m128i*)(dst + i), _mm_and_si128(out, rgbMask));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = blendColor(color, dst[i], a);
     }
+}
+
+static void blendRunPerPixel(Uint32* dst, const Uint32* src, int count) {
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+
+    // Aligned on the framebuffer side, as in blendRunConstant; the source
+    // may start anywhere
+    for (; i < count && !isAligned(dst + i); i++) {
+        dst[i] = blendColor(src[i], dst[i], src[i] >> 24);
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_load_si128((const __m128i*)(dst + i));
+
+        __m128i sLo = _mm_unpacklo_epi8(s, zero);
+        __m128i sHi = _mm_unpackhi_epi8(s, zero);
+        // Copy each pixel's alpha lane across its four channel lanes
+        __m128i aLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sLo, 0xFF), 0xFF);
+        __m128i aHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sHi, 0xFF), 0xFF);
+
+        __m128i lo = _mm_add_epi16(
+            _mm_add_epi16(_mm_mullo_epi16(sLo, aLo),
+                          _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(full, aLo))),
+            half);
+        __m128i hi = _mm_add_epi16(
+            _mm_add_epi16(_mm_mullo_epi16(sHi, aHi),
+                          _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(full, aHi))),
+            half);
+        __m128i out = _mm_packus_epi16(divide255(lo), divide255(hi));
+        _mm_store_si128((__m128i*)(dst + i), _mm_and_si128(out, rgbMask));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = blendColor(src[i], dst[i], src[i] >> 24);
+    }
+}
 
-    Mix_FreeChunk(gScratch);
-    p->running = false;
-    return 0;
+// Present modes, by name for --present
+static const struct {
+    const char* name;
+    PresentMode mode;
+} PRESENT_MODES[] = {
+    {"vsync", PresentMode::Vsync},
+    {"adaptive", PresentMode::Adaptive},
+    {"software", PresentMode::Software},
+    {"accelerated", PresentMode::Accelerated},
+    {"uncapped", PresentMode::Uncapped},
+};
+
+bool parsePresentMode(const char* name, PresentMode& mode) {
+    for (const auto& entry : PRESENT_MODES) {
+        if (strcmp(name, entry.name) == 0) {
+            mode = entry.mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* presentModeName(PresentMode mode) {
+    for (const auto& entry : PRESENT_MODES) {
+        if (entry.mode == mode) return entry.name;
+    }
+    return "unknown";
+}
+
+static Uint32 rendererFlags(PresentMode mode) {
+    switch (mode) {
+        case PresentMode::Vsync:
+        case PresentMode::Adaptive:
+            return SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+        case PresentMode::Software:
+            return SDL_RENDERER_SOFTWARE;
+        default:
+            return SDL_RENDERER_ACCELERATED;
+    }
 }
 
 // SDL Plotter Function Definitions
 
-SDL_Plotter::SDL_Plotter(int r, int c, bool WITH_SOUND) {
+// Pixels per FRAMEBUFFER_ALIGNMENT bytes
+const int ALIGNMENT_PIXELS = FRAMEBUFFER_ALIGNMENT / (int)sizeof(Uint32);
+
+static int roundUpToAlignment(int pixelCount) {
+    return (pixelCount + ALIGNMENT_PIXELS - 1) / ALIGNMENT_PIXELS * ALIGNMENT_PIXELS;
+}
+
+SDL_Plotter::SDL_Plotter(int r, int c, bool WITH_SOUND, PresentMode present, int gx, int gy) {
     row = r;
     col = c;
+    // The left band is rounded up so the window's rows stay aligned too
+    guardX = roundUpToAlignment(std::max(gx, 0));
+    guardY = std::max(gy, 0);
+    pitch = roundUpToAlignment(guardX + col + guardX);
     // leftMouseButtonDown = false;
     quit = false;
+    presentMode = present;
+    vsynced = false;
+    exposed = false;
     SOUND = WITH_SOUND;
     currentKeyStates = NULL;
+    inputQueue = nullptr;
 
-    SDL_Init(SDL_INIT_AUDIO);
+    SDL_Init(SDL_INIT_VIDEO);
 
     window = SDL_CreateWindow("SDL2 Pixel Drawing",
                               SDL_WINDOWPOS_UNDEFINED,
                               SDL_WINDOWPOS_UNDEFINED, col, row, 0);
 
-    renderer = SDL_CreateRenderer(window, -1, 0);
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags(present));
+    if (renderer == NULL) {
+        cout << "SDL renderer Error: " << SDL_GetError() << "; using the default renderer" << endl;
+        renderer = SDL_CreateRenderer(window, -1, 0);
+    }
+
+    SDL_RendererInfo info;
+    if (renderer != NULL && SDL_GetRendererInfo(renderer, &info) == 0) {
+        vsynced = (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+        // Adaptive vsync is a swap interval of -1, which only OpenGL
+        // renderers can ask for; the others stay on plain vsync
+        if (present == PresentMode::Adaptive && vsynced &&
+            (strncmp(info.name, "opengl", 6) != 0 || SDL_GL_SetSwapInterval(-1) != 0)) {
+            cout << "Present Error: no adaptive vsync with the " << info.name << " renderer; using vsync" << endl;
+        }
+    }
 
     texture = SDL_CreateTexture(renderer,
                                 SDL_PIXELFORMAT_ARGB8888,
                                 SDL_TEXTUREACCESS_STATIC, col, row);
 
-    pixels = new Uint32[col * row];
+    size_t bufferPixels = (size_t)pitch * (guardY + row + guardY);
+    buffer = static_cast<Uint32*>(
+        ::operator new(bufferPixels * sizeof(Uint32), std::align_val_t(FRAMEBUFFER_ALIGNMENT)));
+    pixels = buffer + guardY * pitch + guardX;
 
-    memset(pixels, WHITE, col * row * sizeof(Uint32));
+    memset(buffer, WHITE, bufferPixels * sizeof(Uint32));
 
     currentKeyStates = SDL_GetKeyboardState(NULL);
-
-    // SOUND Thread Pool
-    Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048);
-    soundCount = 0;
-    update();
 }
 
 SDL_Plotter::~SDL_Plotter() {
-    delete[] pixels;
+    ::operator delete(buffer, std::align_val_t(FRAMEBUFFER_ALIGNMENT));
     SDL_DestroyTexture(texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -82,51 +238,127 @@ SDL_Plotter::~SDL_Plotter() {
 }
 
 void SDL_Plotter::update() {
-    SDL_UpdateTexture(texture, NULL, pixels, col * sizeof(Uint32));
+    AllocationScope scope(Subsystem::Plotter);
+    // Only the window: SDL steps over the guard band with the pitch
+    SDL_UpdateTexture(texture, NULL, pixels, pitch * sizeof(Uint32));
     SDL_RenderClear(renderer);
     SDL_RenderCopy(renderer, texture, NULL, NULL);
     SDL_RenderPresent(renderer);
 }
 
 Uint32 SDL_Plotter::getColor(int x, int y) {
-    return pixels[y * col + x];
+    return pixels[y * pitch + x];
 }
 
-bool SDL_Plotter::getQuit() {
-    // Handle events on queue
+void SDL_Plotter::pumpEvents() {
+    AllocationScope scope(Subsystem::Plotter);
     while (SDL_PollEvent(&event) != 0) {
+        Uint32 timestamp = event.common.timestamp;
         if (event.type == SDL_TEXTINPUT) {
-            key_queue.push(getKeyPress(event));
+            queueKey(getKeyPress(event), timestamp);
         } else if (event.type == SDL_KEYDOWN) {
             // Make the arrow keys work
-            if (currentKeyStates[SDL_SCANCODE_DOWN]) key_queue.push(DOWN_ARROW);
-            if (currentKeyStates[SDL_SCANCODE_UP]) key_queue.push(UP_ARROW);
-            if (currentKeyStates[SDL_SCANCODE_LEFT]) key_queue.push(LEFT_ARROW);
-            if (currentKeyStates[SDL_SCANCODE_RIGHT]) key_queue.push(RIGHT_ARROW);
-        } else if (event.type == SDL_MOUSEBUTTONUP) {
-            point p;
-            SDL_GetMouseState(&p.x, &p.y);
-            click_queue.push(p);
+            if (currentKeyStates[SDL_SCANCODE_DOWN]) queueKey(DOWN_ARROW, timestamp);
+            if (currentKeyStates[SDL_SCANCODE_UP]) queueKey(UP_ARROW, timestamp);
+            if (currentKeyStates[SDL_SCANCODE_LEFT]) queueKey(LEFT_ARROW, timestamp);
+            if (currentKeyStates[SDL_SCANCODE_RIGHT]) queueKey(RIGHT_ARROW, timestamp);
+            // Backspace is held to rewind, so its release counts too
+            if (event.key.keysym.scancode == SDL_SCANCODE_BACKSPACE && !event.key.repeat) {
+                queueKey(BACKSPACE, timestamp);
+            }
+        } else if (event.type == SDL_KEYUP) {
+            if (event.key.keysym.scancode == SDL_SCANCODE_BACKSPACE) {
+                queueKey(BACKSPACE, timestamp, INPUT_KEY_UP);
+            }
         } else if (event.type == SDL_MOUSEBUTTONDOWN) {
-            // SDL_GetMouseState( &mouse_X, &mouse_Y );
-            // mouseClick = true;
+            queueMouse(INPUT_MOUSE_DOWN, event.button.x, event.button.y, timestamp);
+        } else if (event.type == SDL_MOUSEBUTTONUP) {
+            queueMouse(INPUT_MOUSE_UP, event.button.x, event.button.y, timestamp);
+        } else if (event.type == SDL_WINDOWEVENT) {
+            if (event.window.event == SDL_WINDOWEVENT_EXPOSED ||
+                event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                exposed = true;
+            }
         } else if (event.type == SDL_MOUSEMOTION) {
-            // SDL_PushEvent(&event);
+            // The input queue only gets drags; idle hovering would just
+            // fill it
+            if (inputQueue == nullptr || event.motion.state != 0) {
+                queueMouse(INPUT_MOUSE_MOTION, event.motion.x, event.motion.y, timestamp);
+            }
         }
 
         if (event.type == SDL_QUIT || currentKeyStates[SDL_SCANCODE_ESCAPE]) {
             quit = true;
         }
     }
+}
+
+PresentMode SDL_Plotter::getPresentMode() const {
+    return presentMode;
+}
+
+bool SDL_Plotter::isVsynced() const {
+    return vsynced;
+}
+
+bool SDL_Plotter::waitEvent(int timeoutMs) {
+    return SDL_WaitEventTimeout(NULL, timeoutMs) != 0;
+}
+
+bool SDL_Plotter::takeExposed() {
+    bool wasExposed = exposed;
+    exposed = false;
+    return wasExposed;
+}
+
+bool SDL_Plotter::getQuit() {
+    pumpEvents();
     return quit;
 }
 
+void SDL_Plotter::queueKey(char key, Uint32 timestamp, int type) {
+    if (inputQueue != nullptr) {
+        InputEvent e;
+        e.timestamp = timestamp;
+        e.type = type;
+        e.key = key;
+        e.x = e.y = 0;
+        inputQueue->push(e);
+    } else if (type == INPUT_KEY) {
+        key_queue.push(key);
+    }
+}
+
+void SDL_Plotter::queueMouse(int type, int x, int y, Uint32 timestamp) {
+    point p(x, y);
+    if (inputQueue != nullptr) {
+        InputEvent e;
+        e.timestamp = timestamp;
+        e.type = type;
+        e.key = '\0';
+        e.x = x;
+        e.y = y;
+        inputQueue->push(e);
+    } else if (type == INPUT_MOUSE_DOWN) {
+        mouse_down_queue.push(p);
+    } else if (type == INPUT_MOUSE_UP) {
+        mouse_up_queue.push(p);
+        click_queue.push(p);
+    } else {
+        mouse_motion_queue.push(p);
+    }
+}
+
+void SDL_Plotter::setInputQueue(InputQueue* queue) {
+    inputQueue = queue;
+}
+
 bool SDL_Plotter::kbhit() {
-    return key_queue.size() > 0;
+    return !key_queue.empty();
 }
 
 bool SDL_Plotter::mouseClick() {
-    return click_queue.size() > 0;
+    return !click_queue.empty();
 }
 
 char SDL_Plotter::getKeyPress(SDL_Event& event) {
@@ -135,21 +367,13 @@ char SDL_Plotter::getKeyPress(SDL_Event& event) {
 
 char SDL_Plotter::getKey() {
     char key = '\0';
-    if (key_queue.size() > 0) {
-        key = key_queue.front();
-        key_queue.pop();
-    }
-
+    key_queue.pop(key);
     return key;
 }
 
 point SDL_Plotter::getMouseClick() {
     point p;
-    if (click_queue.size() > 0) {
-        p = click_queue.front();
-        click_queue.pop();
-    }
-
+    click_queue.pop(p);
     return p;
 }
 
@@ -167,12 +391,98 @@ void SDL_Plotter::plotPixel(point p, color c) {
 
 void SDL_Plotter::plotPixel(int x, int y, int r, int g, int b) {
     if (x >= 0 && y >= 0 && x < col && y < row) {
-        pixels[y * col + x] = RED_SHIFT * r + GREEN_SHIFT * g + BLUE_SHIFT * b;
+        pixels[y * pitch + x] = RED_SHIFT * r + GREEN_SHIFT * g + BLUE_SHIFT * b;
     }
 }
 
+template <ClipMode Clip>
+void SDL_Plotter::plotSpan(int x0, int x1, int y, int r, int g, int b) {
+    blendRun<Clip, BlendMode::Opaque>(x0, x1, y, RED_SHIFT * r + GREEN_SHIFT * g + BLUE_SHIFT * b, 255);
+}
+
+template <ClipMode Clip>
+void SDL_Plotter::blendPixel(int x, int y, int r, int g, int b, int a) {
+    if (a <= 0) return;
+    if constexpr (Clip == ClipMode::Clipped) {
+        if (x < 0 || y < 0 || x >= col || y >= row) return;
+    }
+
+    Uint32 color = packColor(r, g, b);
+    Uint32& dst = rowPointer(y)[x];
+    if (a >= 255) {
+        dst = color;
+        return;
+    }
+    dst = blendColor(color, dst, a);
+}
+
+template <ClipMode Clip>
+void SDL_Plotter::blendSpan(int x0, int x1, int y, int r, int g, int b, int a) {
+    if (a <= 0) return;
+    if (a >= 255) {
+        blendRun<Clip, BlendMode::Opaque>(x0, x1, y, packColor(r, g, b), 255);
+    } else {
+        blendRun<Clip, BlendMode::Alpha>(x0, x1, y, packColor(r, g, b), a);
+    }
+}
+
+template <ClipMode Clip, BlendMode Mode>
+void SDL_Plotter::blendRun(int x0, int x1, int y, Uint32 color, int a) {
+    if constexpr (Clip == ClipMode::Clipped) {
+        if (y < 0 || y >= row) return;
+        if (x0 < 0) x0 = 0;
+        if (x1 >= col) x1 = col - 1;
+        if (x0 > x1) return;
+    }
+
+    Uint32* line = rowPointer(y);
+    if constexpr (Mode == BlendMode::Opaque) {
+        std::fill(line + x0, line + x1 + 1, color);
+    } else {
+        blendRunConstant(line + x0, x1 - x0 + 1, color, a);
+    }
+}
+
+template void SDL_Plotter::plotSpan<ClipMode::Clipped>(int, int, int, int, int, int);
+template void SDL_Plotter::plotSpan<ClipMode::Unclipped>(int, int, int, int, int, int);
+template void SDL_Plotter::blendPixel<ClipMode::Clipped>(int, int, int, int, int, int);
+template void SDL_Plotter::blendPixel<ClipMode::Unclipped>(int, int, int, int, int, int);
+template void SDL_Plotter::blendSpan<ClipMode::Clipped>(int, int, int, int, int, int, int);
+template void SDL_Plotter::blendSpan<ClipMode::Unclipped>(int, int, int, int, int, int, int);
+template void SDL_Plotter::blendRun<ClipMode::Clipped, BlendMode::Opaque>(int, int, int, Uint32, int);
+template void SDL_Plotter::blendRun<ClipMode::Clipped, BlendMode::Alpha>(int, int, int, Uint32, int);
+template void SDL_Plotter::blendRun<ClipMode::Unclipped, BlendMode::Opaque>(int, int, int, Uint32, int);
+template void SDL_Plotter::blendRun<ClipMode::Unclipped, BlendMode::Alpha>(int, int, int, Uint32, int);
+
+bool SDL_Plotter::contains(int x, int y, int w, int h) const {
+    return w > 0 && h > 0 && x >= -guardX && y >= -guardY && x + w <= col + guardX && y + h <= row + guardY;
+}
+
+Uint32* SDL_Plotter::rowPointer(int y) {
+    return pixels + y * pitch;
+}
+
+int SDL_Plotter::getPitch() const {
+    return pitch;
+}
+
+void SDL_Plotter::blendSpan(int x, int y, const Uint32* src, int count) {
+    if (y < 0 || y >= row) return;
+    if (x < 0) {
+        src -= x;
+        count += x;
+        x = 0;
+    }
+    if (x + count > col) count = col - x;
+    if (count <= 0) return;
+
+    blendRunPerPixel(rowPointer(y) + x, src, count);
+}
+
 void SDL_Plotter::clear() {
-    memset(pixels, WHITE, col * row * sizeof(Uint32));
+    for (int y = 0; y < row; y++) {
+        memset(rowPointer(y), WHITE, col * sizeof(Uint32));
+    }
 }
 
 int SDL_Plotter::getRow() {
@@ -183,14 +493,12 @@ int SDL_Plotter::getCol() {
     return col;
 }
 
-void SDL_Plotter::initSound(string sound) {
-    if (!soundMap[sound].running) {
-        param* p = &soundMap[sound];
-        p->name = sound;
-        p->cond = SDL_CreateCond();
-        p->mut = SDL_CreateMutex();
-
-        p->threadID = SDL_CreateThread(Sound, sound.c_str(), (void*)p);
+void SDL_Plotter::initSound(const string& sound) {
+    if (SOUND && soundIds.find(sound) == soundIds.end()) {
+        int id = sounds.load(sound);
+        if (id >= 0) {
+            soundIds[sound] = id;
+        }
     }
 }
 
@@ -198,15 +506,15 @@ void SDL_Plotter::setQuit(bool flag) {
     this->quit = flag;
 }
 
-void SDL_Plotter::playSound(string sound) {
-    if (soundMap[sound].running) {
-        SDL_CondSignal(soundMap[sound].cond);
+void SDL_Plotter::playSound(const string& sound) {
+    map<string, int>::const_iterator it = soundIds.find(sound);
+    if (it != soundIds.end()) {
+        sounds.play(it->second);
     }
 }
 
-void SDL_Plotter::quitSound(string sound) {
-    soundMap[sound].running = false;
-    SDL_CondSignal(soundMap[sound].cond);
+void SDL_Plotter::quitSound(const string& sound) {
+    soundIds.erase(sound);
 }
 
 void SDL_Plotter::Sleep(int ms) {
@@ -214,51 +522,29 @@ void SDL_Plotter::Sleep(int ms) {
 }
 
 bool SDL_Plotter::getMouseDown(int& x, int& y) {
-    bool flag = false;
-    x = y = 0;
-    if (SDL_PollEvent(&event)) {
-        if (event.type == SDL_MOUSEBUTTONDOWN) {
-            // Get mouse position
-            flag = true;
-            SDL_GetMouseState(&x, &y);
-        } else {
-            SDL_PushEvent(&event);
-        }
-    }
+    point p;
+    bool flag = mouse_down_queue.pop(p);
+    x = p.x;
+    y = p.y;
     return flag;
 }
 
 bool SDL_Plotter::getMouseUp(int& x, int& y) {
-    bool flag = false;
-    x = y = 0;
-    if (SDL_PollEvent(&event)) {
-        if (event.type == SDL_MOUSEBUTTONUP) {
-            // Get mouse position
-            flag = true;
-            SDL_GetMouseState(&x, &y);
-        } else {
-            SDL_PushEvent(&event);
-        }
-    }
+    point p;
+    bool flag = mouse_up_queue.pop(p);
+    x = p.x;
+    y = p.y;
     return flag;
 }
 
 bool SDL_Plotter::getMouseMotion(int& x, int& y) {
-    bool flag = false;
-    x = y = 0;
-    if (SDL_PollEvent(&event)) {
-        if (event.type == SDL_MOUSEMOTION) {
-            // Get mouse position
-            flag = true;
-            SDL_GetMouseState(&x, &y);
-        } else {
-            SDL_PushEvent(&event);
-        }
-    }
+    point p;
+    bool flag = mouse_motion_queue.pop(p);
+    x = p.x;
+    y = p.y;
     return flag;
 }
 
 void SDL_Plotter::getMouseLocation(int& x, int& y) {
     SDL_GetMouseState(&x, &y);
-    cout << x << " " << y << endl;
 }
@@ -26,7 +26,6 @@
 // OSX Library
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
-#include <SDL2/SDL_thread.h>
 
 // Windows Library
 // #include <SDL2/SDL.h>
@@ -34,22 +33,76 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <map>
-#include <queue>
 #include <string>
+
+#include "Audio.h"
+#include "Constants.h"
+#include "InputQueue.h"
 using namespace std;
 
-const char UP_ARROW = 1;
-const char DOWN_ARROW = 2;
-const char LEFT_ARROW = 3;
-const char RIGHT_ARROW = 4;
 const int RED_SHIFT = 65536;
 const int GREEN_SHIFT = 256;
 const int BLUE_SHIFT = 1;
 const int ALPHA_SHIFT = 16777216;
 const int WHITE = 255;
-const int MAX_THREAD = 100;
+
+// Whether a drawing call clips to the window. A caller that has already
+// checked that its bounding box is inside the framebuffer (see contains)
+// uses Unclipped, which skips every per-span and per-pixel test. The
+// framebuffer may be larger than the window by a guard band that is never
+// shown, so shapes hanging a little off-screen need no clipping either.
+enum class ClipMode { Clipped, Unclipped };
+
+// How a run of pixels takes a color: Opaque stores it and Alpha blends
+// it. Callers check the opacity once per glyph, string or rectangle and
+// then pick a mode, so the per-span work has no alpha branches.
+enum class BlendMode { Opaque, Alpha };
+
+// description: clamps a color channel
+// return: int between 0 and 255
+// precondition: none
+// postcondition: none
+constexpr int clampChannel(int v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// description: packs an RGB color into a framebuffer pixel, clamping
+//              each channel
+// return: Uint32 (0x00RRGGBB)
+// precondition: none
+// postcondition: none
+constexpr Uint32 packColor(int r, int g, int b) {
+    return RED_SHIFT * clampChannel(r) + GREEN_SHIFT * clampChannel(g) + BLUE_SHIFT * clampChannel(b);
+}
+
+// Framebuffer rows, and the window inside them, start on a cache line
+// (and any SIMD register) boundary
+const int FRAMEBUFFER_ALIGNMENT = 64;
+
+// How frames reach the screen. Vsync and Adaptive present in step with
+// the display; Adaptive shows a frame that missed the refresh at once
+// (tearing) instead of a whole refresh late, where the driver can.
+// Software and Accelerated choose the renderer and leave pacing to the
+// game loop. Uncapped presents each frame as soon as it is ready, which
+// is still once per simulation tick.
+enum class PresentMode { Vsync, Adaptive, Software, Accelerated, Uncapped };
+
+// description: looks up a present mode by name (vsync, adaptive,
+//              software, accelerated or uncapped)
+// return: bool, false if name is not a mode
+// precondition: name is not null
+// postcondition: mode set if true was returned
+bool parsePresentMode(const char* name, PresentMode& mode);
+
+// description: names a present mode
+// return: const char* (as accepted by parsePresentMode)
+// precondition: none
+// postcondition: none
+const char* presentModeName(PresentMode mode);
 
 // Point
 struct point {
@@ -78,48 +131,38 @@ struct color {
     }
 };
 
-// Threaded Sound Function
-struct param {
-    bool play;
-    bool running;
-    bool pause;
-    SDL_Thread* threadID;
-    SDL_cond* cond;
-    SDL_mutex* mut;
-    string name;
-
-    param() {
-        play = false;
-        running = false;
-        pause = false;
-        cond = nullptr;
-        mut = nullptr;
-        threadID = nullptr;
-        name = "";
-    }
-};
-
 class SDL_Plotter {
    private:
     SDL_Texture* texture;
     SDL_Renderer* renderer;
     SDL_Window* window;
-    Uint32* pixels;
+    Uint32* buffer;  // the whole framebuffer, guard band included
+    Uint32* pixels;  // the window's top-left pixel inside buffer
+    int pitch;       // pixels from one row to the next
+    int guardX, guardY;
     const Uint8* currentKeyStates;
     SDL_Event event;
     int row, col;
-    bool quit;
-
-    // Keyboard Stuff
-    queue<char> key_queue;
-
-    // Mouse Stuff
-    queue<point> click_queue;
+    std::atomic<bool> quit;  // also set by the game on the simulation thread
+    PresentMode presentMode;
+    bool vsynced;  // present blocks until the display refresh
+    bool exposed;  // the window was uncovered or resized since takeExposed
+
+    // Input Stuff
+    // pumpEvents sorts every SDL event into one of these fixed-size
+    // queues (or into inputQueue when one is attached); nothing else
+    // reads the SDL event queue.
+    InputQueue* inputQueue;
+    SpscQueue<char, 256> key_queue;
+    SpscQueue<point, 64> click_queue;
+    SpscQueue<point, 64> mouse_down_queue;
+    SpscQueue<point, 64> mouse_up_queue;
+    SpscQueue<point, 256> mouse_motion_queue;
 
     // Sound Stuff
     bool SOUND;
-    int soundCount;
-    map<string, param> soundMap;
+    SoundBank sounds;
+    map<string, int> soundIds;
 
     // description: converts SDL keyboard event to char
     // return: char of key pressed
@@ -127,12 +170,37 @@ class SDL_Plotter {
     // postcondition: char representation of key returned
     char getKeyPress(SDL_Event& event);
 
+    // description: hands a key press (or release) to the input queue,
+    //              or a press to the kbhit/getKey queue if no input
+    //              queue is attached
+    // return: void
+    // precondition: timestamp is the SDL tick the event arrived at; type
+    //               is INPUT_KEY or INPUT_KEY_UP
+    // postcondition: key queued for the game
+    void queueKey(char key, Uint32 timestamp, int type = INPUT_KEY);
+
+    // description: hands a mouse action to the input queue, or to its
+    //              typed queue if no input queue is attached
+    // return: void
+    // precondition: type is INPUT_MOUSE_DOWN, _UP or _MOTION
+    // postcondition: action queued for the game
+    void queueMouse(int type, int x, int y, Uint32 timestamp);
+
 public:
     // description: makes SDL_Plotter window
     // return: N/A (constructor)
     // precondition: SDL2 installed
-    // postcondition: window created, sound initialized if WITH_SOUND true
-    SDL_Plotter(int r = 480, int c = 640, bool WITH_SOUND = true);
+    // postcondition: window created (nothing presented until the first
+    //                update); initSound/playSound enabled if
+    //                WITH_SOUND true (the mixer is opened by AudioContext);
+    //                renderer chosen for present (the default renderer if
+    //                that one cannot be made); framebuffer allocated
+    //                with a band of at least guardX columns left and
+    //                right of the window and guardY rows above and below
+    //                it, 64-byte aligned, with each row padded to a
+    //                multiple of 64 bytes
+    SDL_Plotter(int r = 480, int c = 640, bool WITH_SOUND = true,
+                PresentMode present = PresentMode::Accelerated, int guardX = 0, int guardY = 0);
 
     // description: cleans up SDL_Plotter
     // return: N/A (destructor)
@@ -143,21 +211,62 @@ public:
     // description: refreshes screen with pixel buffer
     // return: void
     // precondition: window initialized
-    // postcondition: screen updated, events handled
+    // postcondition: screen updated from the window's pixels only, the
+    //                guard band is not uploaded
     void update();
 
-    // description: check if user wants to quit
+    // description: gets the present mode the plotter was made with
+    // return: PresentMode
+    // precondition: none
+    // postcondition: none
+    PresentMode getPresentMode() const;
+
+    // description: checks whether update() waits for the display refresh
+    // return: bool, true if the renderer granted vsync
+    // precondition: none
+    // postcondition: none
+    bool isVsynced() const;
+
+    // description: drain SDL's event queue into the typed input queues
+    // return: void
+    // precondition: called on the thread that created the window
+    // postcondition: keys, clicks, mouse down/up/motion queued; quit set
+    //                if the window was closed or escape pressed
+    void pumpEvents();
+
+    // description: sleeps until an SDL event arrives, for loops with
+    //              nothing to draw
+    // return: bool, false if timeoutMs passed without an event
+    // precondition: called on the thread that created the window
+    // postcondition: the event is left for pumpEvents
+    bool waitEvent(int timeoutMs);
+
+    // description: checks whether the window has to be presented again
+    //              because it was uncovered or resized
+    // return: bool
+    // precondition: none
+    // postcondition: flag cleared
+    bool takeExposed();
+
+    // description: pump events, then check if user wants to quit
     // return: bool quit status
     // precondition: object exists
-    // postcondition: quit flag returned
+    // postcondition: events pumped, quit flag returned
     bool getQuit();
 
     // description: set quit flag
     // return: void
-    // precondition: object exists
+    // precondition: object exists; safe to call from any thread
     // postcondition: quit set to flag
     void setQuit(bool flag);
 
+    // description: route key presses into a timestamped input queue
+    // return: void
+    // precondition: queue outlives the plotter, or nullptr to detach
+    // postcondition: pumpEvents pushes key presses and mouse actions
+    //                into queue instead of the typed queues
+    void setInputQueue(InputQueue* queue);
+
     // description: see if key was pressed
     // return: bool if key available
     // precondition: object exists
@@ -206,6 +315,75 @@ public:
     // postcondition: pixel colored at point
     void plotPixel(point p, color = color{});
 
+    // description: fill a horizontal run of pixels with RGB values
+    // return: void
+    // precondition: r,g,b between 0-255; for Unclipped, x0..x1 and y
+    //               inside the framebuffer (see contains) and
+    //               x0 <= x1 + 1
+    // postcondition: pixels x0..x1 (inclusive) on row y colored, with
+    //                the run clipped to the window
+    template <ClipMode Clip = ClipMode::Clipped>
+    void plotSpan(int x0, int x1, int y, int r, int g, int b);
+
+    // description: source-over blend an RGB color into one pixel
+    // return: void
+    // precondition: a between 0 (transparent) and 255 (opaque); for
+    //               Unclipped, x,y inside the framebuffer
+    // postcondition: pixel at x,y mixed toward r,g,b by a/255; off-window
+    //                pixels are ignored
+    template <ClipMode Clip = ClipMode::Clipped>
+    void blendPixel(int x, int y, int r, int g, int b, int a);
+
+    // description: source-over blend a constant color into a run of pixels
+    // return: void
+    // precondition: a between 0 (transparent) and 255 (opaque); for
+    //               Unclipped, as plotSpan
+    // postcondition: pixels x0..x1 (inclusive) on row y mixed toward r,g,b
+    //                by a/255, with the run clipped to the window
+    template <ClipMode Clip = ClipMode::Clipped>
+    void blendSpan(int x0, int x1, int y, int r, int g, int b, int a);
+
+    // description: stores or blends a packed color into a run of pixels,
+    //              with none of blendSpan's checks on the color or alpha:
+    //              the caller has packed the color and picked the mode
+    //              once for a whole primitive
+    // return: void
+    // precondition: color from packColor; a between 0 and 255 (ignored
+    //               when Opaque); for Unclipped, as plotSpan
+    // postcondition: pixels x0..x1 (inclusive) on row y set to color or
+    //                mixed toward it by a/255, with the run clipped to
+    //                the window
+    template <ClipMode Clip, BlendMode Mode>
+    void blendRun(int x0, int x1, int y, Uint32 color, int a);
+
+    // description: source-over blend ARGB8888 pixels with their own alpha
+    // return: void
+    // precondition: src holds count pixels, alpha in the top byte
+    // postcondition: count pixels starting at x on row y blended, with the
+    //                run clipped to the window
+    void blendSpan(int x, int y, const Uint32* src, int count);
+
+    // description: checks whether a rectangle can be drawn unclipped
+    // return: bool (true if w,h > 0 and every pixel of the w x h
+    //         rectangle at x,y is on screen or in the guard band)
+    // precondition: none
+    // postcondition: none
+    bool contains(int x, int y, int w, int h) const;
+
+    // description: raw access to one row of the framebuffer
+    // return: Uint32* (the row's pixel at x = 0, ARGB8888; the guard
+    //         band's columns lie before and after it)
+    // precondition: -guard rows <= y < getRow() + guard rows
+    // postcondition: none; writes through the pointer to on-screen
+    //                pixels show up on the next update()
+    Uint32* rowPointer(int y);
+
+    // description: gets the distance between framebuffer rows
+    // return: int (pixels, a multiple of 16)
+    // precondition: none
+    // postcondition: none
+    int getPitch() const;
+
     // description: make screen black
     // return: void
     // precondition: window initialized
@@ -227,20 +405,21 @@ public:
     // description: load sound file
     // return: void
     // precondition: sound file exists, SOUND enabled
-    // postcondition: sound in soundMap ready to use
-    void initSound(string sound);
+    // postcondition: sound decoded into memory, ready to use
+    void initSound(const string& sound);
 
     // description: play loaded sound
     // return: void
     // precondition: sound initialized
-    // postcondition: sound playing on thread
-    void playSound(string sound);
+    // postcondition: sound playing on a free mixer voice
+    void playSound(const string& sound);
 
-    // description: stop sound and free it
+    // description: forget a loaded sound
     // return: void
-    // precondition: sound in soundMap
-    // postcondition: sound thread ended, memory freed
-    void quitSound(string sound);
+    // precondition: sound initialized
+    // postcondition: playSound ignores sound until it is loaded again;
+    //                its memory is released with the plotter
+    void quitSound(const string& sound);
 
     // description: wait for ms milliseconds
     // return: void
@@ -248,22 +427,22 @@ public:
     // postcondition: execution paused for ms milliseconds
     void Sleep(int ms);
 
-    // description: check if mouse button pressed
-    // return: bool if button down
+    // description: take the next mouse button press from its queue
+    // return: bool if a press was queued
     // precondition: object exists
-    // postcondition: x,y have mouse coords if true
+    // postcondition: x,y have press coords if true, else 0
     bool getMouseDown(int& x, int& y);
 
-    // description: check if mouse button released
-    // return: bool if button up
+    // description: take the next mouse button release from its queue
+    // return: bool if a release was queued
     // precondition: object exists
-    // postcondition: x,y have mouse coords if true
+    // postcondition: x,y have release coords if true, else 0
     bool getMouseUp(int& x, int& y);
 
-    // description: check if mouse moving
-    // return: bool if mouse moved
+    // description: take the next mouse motion from its queue
+    // return: bool if a motion was queued
     // precondition: object exists
-    // postcondition: x,y have mouse coords if true
+    // postcondition: x,y have mouse coords if true, else 0
     bool getMouseMotion(int& x, int& y);
 
     // description: get where mouse is
@@ -0,0 +1,199 @@
+#include "SimulationThread.h"
+
+#include "Constants.h"
+
+// Most ticks simulated back to back before a snapshot is published
+const int MAX_CATCHUP_TICKS = 5;
+
+SimulationThread::SimulationThread(SubwaySurferGame& game, TripleBuffer<GameSnapshot>& snapshots,
+                                   InputQueue& input, InputQueue& live, Replay& replay, SimulationMode mode)
+    : game(game),
+      snapshots(snapshots),
+      input(input),
+      live(live),
+      replay(replay),
+      mode(mode),
+      tick(0),
+      autopilot(nullptr),
+      running(false),
+      finished(false),
+      idle(false),
+      woken(false) {}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::setAutopilot(Autopilot* pilot) {
+    autopilot = pilot;
+}
+
+void SimulationThread::start() {
+    if (thread.joinable()) return;
+    running.store(true);
+    if (mode == SimulationMode::Headless) {
+        thread = std::thread(&SimulationThread::runHeadless, this);
+    } else {
+        thread = std::thread(&SimulationThread::runRealTime, this);
+    }
+}
+
+void SimulationThread::stop() {
+    running.store(false);
+    if (mode == SimulationMode::Headless) {
+        // Take whatever is waiting, in case the thread is blocked handing
+        // over another snapshot; it sees running cleared after that one
+        snapshots.acquire();
+    }
+    wake();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void SimulationThread::wake() {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    if (idle.load(std::memory_order_relaxed) || !running.load(std::memory_order_relaxed)) {
+        // Cleared here rather than by the woken thread, so the caller does
+        // not go back to idling before the new input's snapshot is out
+        idle.store(false, std::memory_order_release);
+        woken = true;
+        wakeSignal.notify_one();
+    }
+}
+
+bool SimulationThread::isIdle() const {
+    return idle.load(std::memory_order_acquire);
+}
+
+bool SimulationThread::isFinished() const {
+    return finished.load(std::memory_order_acquire);
+}
+
+Uint32 SimulationThread::getTick() const {
+    return tick;
+}
+
+// Moves the events due by tickEnd from one queue to the other, as
+// recording does without keeping them
+static void forwardInput(InputQueue& source, InputQueue& dest, Uint32 tickEnd) {
+    InputEvent e;
+    while (source.peek(e) && (Sint32)(e.timestamp - tickEnd) <= 0) {
+        source.pop(e);
+        dest.push(e);
+    }
+}
+
+void SimulationThread::steer(Uint32 tickEnd) {
+    if (autopilot == nullptr) return;
+    // Recording already moved the player's events; headless has none
+    if (mode == SimulationMode::Live) {
+        forwardInput(live, input, tickEnd);
+    }
+
+    char key = autopilot->choose(game.getState());
+    if (key != 0) {
+        InputEvent e = {};
+        e.timestamp = tickEnd;
+        e.type = INPUT_KEY;
+        e.key = key;
+        autopilotKeys.push(e);
+    }
+    if (mode == SimulationMode::Record) {
+        replay.record(autopilotKeys, input, tick, tickEnd);
+    } else {
+        forwardInput(autopilotKeys, input, tickEnd);
+    }
+}
+
+void SimulationThread::fillSnapshot(Uint32 tickEnd) {
+    GameSnapshot& frame = snapshots.writeSlot();
+    game.writeSnapshot(frame);
+    frame.tick = tick;
+    frame.tickEnd = tickEnd;
+}
+
+void SimulationThread::waitForInput() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    // Set under the lock, then check the queues: input pushed before a
+    // wake that saw idle still false is caught here instead. A wake with
+    // nothing queued (the main loop wakes after every pump) waits again.
+    while (input.empty() && live.empty() && running.load()) {
+        idle.store(true, std::memory_order_release);
+        wakeSignal.wait(lock, [this] { return woken; });
+        woken = false;
+    }
+    woken = false;
+    idle.store(false, std::memory_order_release);
+}
+
+void SimulationThread::runRealTime() {
+    Uint32 nextTick = SDL_GetTicks();
+    while (running.load(std::memory_order_relaxed)) {
+        int ticksRun = 0;
+        while ((Sint32)(SDL_GetTicks() - nextTick) >= 0 && ticksRun < MAX_CATCHUP_TICKS) {
+            nextTick += TICK_MS;
+            if (mode == SimulationMode::Record) {
+                replay.record(live, input, tick, nextTick);
+            } else if (mode == SimulationMode::Replay) {
+                replay.play(input, tick, nextTick);
+            }
+            steer(nextTick);
+            game.update(input, nextTick);
+            if (mode != SimulationMode::Live) {
+                replay.checkTick(tick, game.getState());
+            }
+            tick++;
+            ticksRun++;
+            if (mode == SimulationMode::Replay && tick >= replay.length) break;
+        }
+        if (ticksRun == MAX_CATCHUP_TICKS && (Sint32)(SDL_GetTicks() - nextTick) >= 0) {
+            // Too far behind (e.g. the machine was suspended); drop the
+            // backlog rather than fast-forwarding through it
+            nextTick = SDL_GetTicks();
+        }
+        if (ticksRun > 0) {
+            fillSnapshot(nextTick);
+            snapshots.publish();
+        }
+
+        if (mode == SimulationMode::Replay && tick >= replay.length) {
+            finished.store(true, std::memory_order_release);
+            return;
+        }
+
+        // The start, pause and game-over screens stand still until input
+        // arrives; their last snapshot is already published. A replay has
+        // no input to wake on, so it never idles, and neither does the
+        // autopilot.
+        if (mode != SimulationMode::Replay && autopilot == nullptr && !game.isAnimating() && input.empty() &&
+            live.empty()) {
+            waitForInput();
+            nextTick = SDL_GetTicks();
+            continue;
+        }
+
+        Sint32 wait = (Sint32)(nextTick - SDL_GetTicks());
+        if (wait > 0) {
+            SDL_Delay(wait);
+        }
+    }
+}
+
+void SimulationThread::runHeadless() {
+    while (tick < replay.length && running.load(std::memory_order_relaxed)) {
+        Uint32 tickEnd = (tick + 1) * TICK_MS;
+        replay.play(input, tick, tickEnd);
+        steer(tickEnd);
+        game.update(input, tickEnd);
+        replay.checkTick(tick, game.getState());
+        tick++;
+        fillSnapshot(tickEnd);
+
+        // This tick was simulated while the previous one was drawn; wait
+        // for that one to be taken before handing this one over
+        snapshots.waitUntilTaken();
+        snapshots.publish();
+    }
+    finished.store(true, std::memory_order_release);
+}
@@ -0,0 +1,166 @@
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <SDL2/SDL.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Autopilot.h"
+#include "Game.h"
+#include "GameSnapshot.h"
+#include "InputQueue.h"
+#include "Replay.h"
+#include "TripleBuffer.h"
+
+// Where the simulation's input comes from, and how its ticks are timed
+enum class SimulationMode {
+    Live,      // real time; the game drains the input queue
+    Record,    // real time; live input passes through the recorder
+    Replay,    // real time; input comes from the replay, until its end
+    Headless   // the replay as fast as possible, every tick drawn
+};
+
+// Runs the fixed-tick simulation on its own thread, so tick N is
+// simulated while the main thread draws and presents tick N-1. After
+// each batch of ticks the thread copies the game into the back slot of
+// the snapshot buffer and publishes it; the main thread only ever draws
+// snapshots, so the two never touch the same game state.
+//
+// The main thread keeps pumping SDL events into the input queues; events
+// are stamped on arrival, so each still lands on the first tick ending
+// after it. When the game stands still (start, pause and game-over
+// screens) and no input is waiting, the thread blocks until wake.
+//
+// With an autopilot attached the thread is the only producer of the
+// game's queue: before each tick it forwards the player's events from
+// the live queue, then queues the autopilot's key, recording both when
+// recording. It never idles then, since the autopilot presses on from
+// the start and game-over screens.
+class SimulationThread {
+   private:
+    SubwaySurferGame& game;
+    TripleBuffer<GameSnapshot>& snapshots;
+    InputQueue& input;  // drained by the game
+    InputQueue& live;   // filled by the plotter while recording or autopiloted
+    Replay& replay;
+    SimulationMode mode;
+    Uint32 tick;  // ticks run; read by others only once stopped
+    Autopilot* autopilot;
+    InputQueue autopilotKeys;  // pushed and drained by this thread only
+
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> finished;
+    std::atomic<bool> idle;
+
+    // Wakes the thread out of an idle wait
+    std::mutex wakeMutex;
+    std::condition_variable wakeSignal;
+    bool woken;
+
+    // description: real-time loop: runs the ticks that are due, publishes
+    //              a snapshot, then sleeps until the next tick or idles
+    // return: void
+    // precondition: run on the simulation thread; mode is not Headless
+    // postcondition: returns once stopped, or at the end of a replay
+    void runRealTime();
+
+    // description: headless loop: runs every replay tick back to back,
+    //              publishing each one only after the previous snapshot
+    //              was taken, so none is skipped
+    // return: void
+    // precondition: run on the simulation thread; mode is Headless
+    // postcondition: returns once stopped or at the end of the replay
+    void runHeadless();
+
+    // description: queues this tick's input when an autopilot is attached:
+    //              the player's events, then the autopilot's key
+    // return: void
+    // precondition: tickEnd is the end of the tick about to run
+    // postcondition: events moved to the game's queue (and recorded
+    //                when recording); nothing done without an autopilot
+    void steer(Uint32 tickEnd);
+
+    // description: copies the game into the back slot of the buffer
+    // return: void
+    // precondition: tickEnd is the end of the last tick run
+    // postcondition: back slot holds the current tick, ready to publish
+    void fillSnapshot(Uint32 tickEnd);
+
+    // description: blocks while the game stands still and no input waits
+    // return: void
+    // precondition: run on the simulation thread
+    // postcondition: input queued or stop called; idle cleared
+    void waitForInput();
+
+   public:
+    // description: makes a stopped simulation thread
+    // return: N/A (constructor)
+    // precondition: everything passed outlives the thread; the plotter
+    //               fills input (or live when recording)
+    // postcondition: no thread running until start
+    SimulationThread(SubwaySurferGame& game, TripleBuffer<GameSnapshot>& snapshots, InputQueue& input,
+                     InputQueue& live, Replay& replay, SimulationMode mode);
+
+    // description: stops the thread if it is still running
+    // return: N/A (destructor)
+    // precondition: none
+    // postcondition: thread joined
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // description: lets an autopilot play the game
+    // return: void
+    // precondition: before start; mode is not Replay; pilot outlives the
+    //               thread; the plotter fills live, not input
+    // postcondition: the autopilot chooses a key before every tick
+    void setAutopilot(Autopilot* pilot);
+
+    // description: starts simulating from tick 0 and the current time
+    // return: void
+    // precondition: called at most once; from here on only the
+    //               simulation thread touches the game, except for render
+    //               and sampleTelemetry
+    // postcondition: thread running
+    void start();
+
+    // description: stops the thread and waits for it to exit
+    // return: void
+    // precondition: called from the thread drawing the snapshots
+    // postcondition: thread joined; the game may be used again
+    void stop();
+
+    // description: ends an idle wait, so newly queued input is applied
+    //              at once
+    // return: void
+    // precondition: called after events were pumped into the queues
+    // postcondition: the thread re-checks its input
+    void wake();
+
+    // description: checks whether the thread is waiting for input; a
+    //              snapshot published before it went idle is visible to
+    //              acquire once this returns true
+    // return: bool
+    // precondition: none
+    // postcondition: none
+    bool isIdle() const;
+
+    // description: checks whether a replay has run to its end
+    // return: bool
+    // precondition: none
+    // postcondition: none
+    bool isFinished() const;
+
+    // description: gets the number of ticks run
+    // return: Uint32
+    // precondition: thread stopped
+    // postcondition: none
+    Uint32 getTick() const;
+};
+
+#endif
@@ -0,0 +1,17 @@
+#include "StartupTrace.h"
+
+#include <cstdio>
+
+StartupTrace::StartupTrace(bool enabled)
+    : enabled(enabled), start(std::chrono::steady_clock::now()), last(start) {}
+
+void StartupTrace::mark(const char* phase) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (enabled) {
+        std::printf("startup: %-24s %8.2f ms  (at %8.2f ms)\n", phase,
+                    std::chrono::duration<double, std::milli>(now - last).count(),
+                    std::chrono::duration<double, std::milli>(now - start).count());
+        std::fflush(stdout);
+    }
+    last = now;
+}
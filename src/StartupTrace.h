@@ -0,0 +1,29 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <chrono>
+
+// Times the phases of startup. Each mark() ends a phase and, when the
+// trace is enabled (--startup-trace), prints how long it took and how
+// far into startup it finished. Disabled traces cost a clock read.
+class StartupTrace {
+   private:
+    bool enabled;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point last;
+
+   public:
+    // description: starts timing
+    // return: N/A (constructor)
+    // precondition: none
+    // postcondition: clock started; marks print if enabled
+    StartupTrace(bool enabled);
+
+    // description: ends the current phase
+    // return: void
+    // precondition: phase names what happened since the previous mark
+    // postcondition: phase printed if enabled
+    void mark(const char* phase);
+};
+
+#endif
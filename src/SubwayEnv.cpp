@@ -0,0 +1,254 @@
+#include "SubwayEnv.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "Config.h"
+#include "Constants.h"
+#include "GameState.h"
+#include "Renderer.h"
+#include "SDL_Plotter.h"
+
+// Keys the game takes for each SUBWAY_ACTION_*
+static const char ACTION_KEYS[] = {0, 'a', 'd', 'w'};
+constexpr int ACTION_COUNT = sizeof(ACTION_KEYS);
+
+static_assert(SUBWAY_LANES == NUM_LANES, "the grid has a column per lane");
+static_assert(sizeof(SubwayObservation) == SUBWAY_OBSERVATION_FLOATS * sizeof(float),
+              "observations are read as a plain float array");
+
+// The grid's last row ends where a standing player's hitbox does
+constexpr float GRID_BOTTOM = PLAYER_Y_GROUND + PLAYER_HITBOX_HEIGHT;
+constexpr float GRID_TOP = GRID_BOTTOM - SUBWAY_GRID_ROWS * SUBWAY_GRID_ROW_HEIGHT;
+
+struct SubwayEnv {
+    GameConfig config;
+    std::vector<GameState> states;
+    std::vector<SubwayObservation> observations;
+    int particleLimit;
+
+    // Only with SUBWAY_RENDER
+    std::unique_ptr<SDL_Plotter> plotter;
+    std::unique_ptr<Renderer> renderer;
+};
+
+// Grid row holding screen y, or -1 when y is off the grid
+static int gridRow(float y) {
+    if (y < GRID_TOP || y >= GRID_BOTTOM) return -1;
+    return (int)((y - GRID_TOP) / SUBWAY_GRID_ROW_HEIGHT);
+}
+
+static void observe(const GameState& s, SubwayObservation& o) {
+    std::memset(o.obstacles, 0, sizeof(o.obstacles));
+    std::memset(o.collectibles, 0, sizeof(o.collectibles));
+    std::fill(o.obstacleDistance, o.obstacleDistance + SUBWAY_LANES, SUBWAY_FAR);
+    std::fill(o.collectibleDistance, o.collectibleDistance + SUBWAY_LANES, SUBWAY_FAR);
+    float playerY = (float)s.playerY;
+    float playerBottom = playerY + PLAYER_HITBOX_HEIGHT;
+
+    for (int i = 0; i < s.obstacleCount; i++) {
+        const Obstacle& obs = s.obstacles[i];
+        if (!obs.active) continue;
+        float top = (float)obs.y;
+        float bottom = top + obs.getHeight();
+
+        int first = gridRow(std::max(top, GRID_TOP));
+        int last = gridRow(std::min(bottom, GRID_BOTTOM) - 1);
+        if (first >= 0 && last >= 0) {
+            for (int row = first; row <= last; row++) {
+                o.obstacles[row][obs.lane] = 1;
+            }
+        }
+
+        // Ahead until it has passed below the player
+        if (top < playerBottom) {
+            float distance = std::max(0.0f, playerY - bottom);
+            o.obstacleDistance[obs.lane] = std::min(o.obstacleDistance[obs.lane], distance);
+        }
+    }
+
+    for (int i = 0; i < s.collectibleCount; i++) {
+        const Collectible& col = s.collectibles[i];
+        if (!col.active) continue;
+        float y = (float)col.y;
+        int row = gridRow(y);
+        if (row >= 0) {
+            o.collectibles[row][col.lane] = std::max(o.collectibles[row][col.lane], col.type == 1 ? 2.0f : 1.0f);
+        }
+        if (y < playerY + COLLECT_DISTANCE) {
+            float distance = std::max(0.0f, playerY - y);
+            o.collectibleDistance[col.lane] = std::min(o.collectibleDistance[col.lane], distance);
+        }
+    }
+
+    o.lane = s.currentLane;
+    o.height = PLAYER_Y_GROUND - playerY;
+    o.verticalVelocity = (float)s.verticalVelocity;
+    o.scrollSpeed = (float)s.scrollSpeed;
+    o.score = s.score;
+    o.lives = s.lives;
+    o.level = s.level;
+    o.comboMultiplier = s.comboMultiplier;
+}
+
+SubwayEnv* subway_create(int instances, const char* profile, int flags) {
+    if (instances < 1) {
+        std::cout << "Env Error: an environment needs at least one instance" << std::endl;
+        return nullptr;
+    }
+    try {
+        std::unique_ptr<SubwayEnv> env = std::make_unique<SubwayEnv>();
+        if (profile != nullptr && !loadConfigProfile(profile, env->config)) {
+            return nullptr;
+        }
+        env->states.resize(instances);
+        env->observations.resize(instances);
+        std::memset(env->observations.data(), 0, instances * sizeof(SubwayObservation));
+
+        // Particles never affect play; without a framebuffer to show
+        // them they are only drawn from the generator, never kept
+        env->particleLimit = (flags & SUBWAY_RENDER) ? MAX_PARTICLES : 0;
+        for (GameState& s : env->states) {
+            s.reset(env->config, 1);
+            s.particleLimit = env->particleLimit;
+        }
+
+        if (flags & SUBWAY_RENDER) {
+            // Offscreen unless the caller picked a video driver
+            SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+            env->plotter = std::make_unique<SDL_Plotter>(SCREEN_HEIGHT, SCREEN_WIDTH, false, PresentMode::Software,
+                                                         FRAME_GUARD, FRAME_GUARD);
+            env->renderer = std::make_unique<Renderer>(*env->plotter, SCREEN_WIDTH, SCREEN_HEIGHT);
+        }
+        return env.release();
+    } catch (const std::bad_alloc&) {
+        std::cout << "Env Error: out of memory for " << instances << " instances" << std::endl;
+        return nullptr;
+    }
+}
+
+void subway_destroy(SubwayEnv* env) {
+    delete env;
+}
+
+int subway_instances(const SubwayEnv* env) {
+    return (int)env->states.size();
+}
+
+int subway_observation_floats(void) {
+    return (int)SUBWAY_OBSERVATION_FLOATS;
+}
+
+void subway_reset(SubwayEnv* env, int instance, unsigned seed) {
+    int first = instance < 0 ? 0 : instance;
+    int last = instance < 0 ? (int)env->states.size() - 1 : instance;
+    for (int i = first; i <= last; i++) {
+        GameState& s = env->states[i];
+        s.reset(env->config, instance < 0 ? seed + i : seed);
+        s.particleLimit = env->particleLimit;
+        // As pressing start: the same run the game gives for --seed
+        s.applyKey(env->config, ' ');
+        observe(s, env->observations[i]);
+    }
+}
+
+void subway_step(SubwayEnv* env, const int32_t* actions, float* rewards, uint8_t* dones) {
+    int count = (int)env->states.size();
+    for (int i = 0; i < count; i++) {
+        GameState& s = env->states[i];
+        if (s.gameState != STATE_PLAYING) {
+            if (rewards != nullptr) rewards[i] = 0;
+            if (dones != nullptr) dones[i] = 1;
+            continue;
+        }
+
+        int score = s.score;
+        int action = actions[i];
+        if (action > 0 && action < ACTION_COUNT) {
+            s.applyKey(env->config, ACTION_KEYS[action]);
+        }
+        s.step(env->config);
+
+        if (rewards != nullptr) rewards[i] = (float)(s.score - score);
+        if (dones != nullptr) dones[i] = s.gameState == STATE_GAME_OVER;
+        observe(s, env->observations[i]);
+    }
+}
+
+const SubwayObservation* subway_observations(const SubwayEnv* env) {
+    return env->observations.data();
+}
+
+uint64_t subway_state_hash(const SubwayEnv* env, int instance) {
+    return env->states[instance].hash().combined();
+}
+
+void subway_frame_size(int factor, int* width, int* height) {
+    *width = SCREEN_WIDTH / factor;
+    *height = SCREEN_HEIGHT / factor;
+}
+
+int subway_render(SubwayEnv* env, int instance, int factor, uint32_t* pixels) {
+    if (!env->renderer || instance < 0 || instance >= (int)env->states.size() || factor < 1) return -1;
+
+    const GameState& s = env->states[instance];
+    Renderer& renderer = *env->renderer;
+    renderer.beginFrame();
+    if (s.gameState == STATE_START) {
+        renderer.drawStartScreen();
+    } else {
+        renderer.drawGameState(s);
+        if (s.gameState == STATE_GAME_OVER) {
+            renderer.drawGameOverScreen(s.score, s.level);
+        }
+    }
+
+    int width, height;
+    subway_frame_size(factor, &width, &height);
+    if (factor == 1) {
+        // The framebuffer leaves the alpha byte clear; the frame is
+        // opaque, as the downsampled one is
+        for (int y = 0; y < height; y++) {
+            const Uint32* row = env->plotter->rowPointer(y);
+            uint32_t* out = pixels + y * width;
+            for (int x = 0; x < width; x++) {
+                out[x] = 0xFF000000u | row[x];
+            }
+        }
+        return 0;
+    }
+
+    // Box filter: sum each block's channels along the source rows, then
+    // write the averages out once per output row, dividing by the block
+    // area through a 32.32 reciprocal
+    uint64_t area = (uint64_t)factor * factor;
+    uint64_t reciprocal = ((1ull << 32) + area - 1) / area;
+    Uint32 sums[SCREEN_WIDTH][3];
+    for (int y = 0; y < height; y++) {
+        std::memset(sums, 0, width * sizeof(sums[0]));
+        for (int dy = 0; dy < factor; dy++) {
+            const Uint32* row = env->plotter->rowPointer(y * factor + dy);
+            for (int x = 0; x < width; x++) {
+                Uint32* sum = sums[x];
+                for (int dx = 0; dx < factor; dx++) {
+                    Uint32 p = *row++;
+                    sum[0] += (p >> 16) & 0xFF;
+                    sum[1] += (p >> 8) & 0xFF;
+                    sum[2] += p & 0xFF;
+                }
+            }
+        }
+        uint32_t* out = pixels + y * width;
+        for (int x = 0; x < width; x++) {
+            Uint32 r = (Uint32)std::min<uint64_t>(sums[x][0] * reciprocal >> 32, 255);
+            Uint32 g = (Uint32)std::min<uint64_t>(sums[x][1] * reciprocal >> 32, 255);
+            Uint32 b = (Uint32)std::min<uint64_t>(sums[x][2] * reciprocal >> 32, 255);
+            out[x] = 0xFF000000u | r << 16 | g << 8 | b;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * SubwayEnv.h
+ *
+ * C interface to the game's simulation for training agents, built as
+ * libsubway. An environment holds a batch of independent games
+ * (instances). One subway_step call advances every instance by one tick
+ * and rewrites its observation in place, in a buffer the environment
+ * owns: observations never move and nothing is allocated or copied per
+ * step. The observations of a batch are contiguous floats, so they can
+ * be read as one [instances][SUBWAY_OBSERVATION_FLOATS] array.
+ *
+ * An environment may be used from one thread at a time; separate
+ * environments may be stepped on separate threads.
+ */
+
+#ifndef SUBWAY_ENV_H
+#define SUBWAY_ENV_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define SUBWAY_API __attribute__((visibility("default")))
+#else
+#define SUBWAY_API
+#endif
+
+#define SUBWAY_LANES 3
+
+// The occupancy grid covers a screen of track in rows of
+// SUBWAY_GRID_ROW_HEIGHT pixels; the last row ends at the bottom of the
+// player standing on the ground
+#define SUBWAY_GRID_ROWS 12
+#define SUBWAY_GRID_ROW_HEIGHT 50
+
+// Distance reported for a lane with nothing ahead in it
+#define SUBWAY_FAR 10000.0f
+
+// Actions, one per instance per step
+#define SUBWAY_ACTION_NONE 0
+#define SUBWAY_ACTION_LEFT 1
+#define SUBWAY_ACTION_RIGHT 2
+#define SUBWAY_ACTION_JUMP 3
+
+// subway_create flags
+#define SUBWAY_RENDER 1  // keep particles and allow subway_render
+
+// What an agent sees of one instance after a step. Positions and
+// distances are in screen pixels, velocities in pixels per tick.
+typedef struct SubwayObservation {
+    float obstacles[SUBWAY_GRID_ROWS][SUBWAY_LANES];     // 1 where an obstacle covers the cell
+    float collectibles[SUBWAY_GRID_ROWS][SUBWAY_LANES];  // 1 for a coin, 2 for a heart
+    float obstacleDistance[SUBWAY_LANES];     // from the player's top to the nearest obstacle ahead
+    float collectibleDistance[SUBWAY_LANES];  // from the player's top to the nearest collectible ahead
+    float lane;                               // 0 (left) to SUBWAY_LANES - 1
+    float height;                             // player above the ground
+    float verticalVelocity;                   // negative while rising
+    float scrollSpeed;                        // track speed toward the player
+    float score;
+    float lives;
+    float level;
+    float comboMultiplier;
+} SubwayObservation;
+
+#define SUBWAY_OBSERVATION_FLOATS (sizeof(SubwayObservation) / sizeof(float))
+
+typedef struct SubwayEnv SubwayEnv;
+
+// description: makes an environment of instances games, each waiting for
+//              a reset
+// return: SubwayEnv*, or NULL if instances < 1, memory ran out
+//         or the profile had errors (they are printed)
+// precondition: profile is NULL (default tunables) or names a profile
+//               file as accepted by --profile; at most one environment
+//               at a time is made with SUBWAY_RENDER, since it owns SDL
+// postcondition: observations zeroed; with SUBWAY_RENDER an offscreen
+//                framebuffer is made for subway_render
+SUBWAY_API SubwayEnv* subway_create(int instances, const char* profile, int flags);
+
+// description: frees an environment
+// return: void
+// precondition: env came from subway_create, or is NULL
+// postcondition: env and its observation buffer are gone
+SUBWAY_API void subway_destroy(SubwayEnv* env);
+
+// description: gets the number of instances
+// return: int
+// precondition: env valid
+// postcondition: none
+SUBWAY_API int subway_instances(const SubwayEnv* env);
+
+// description: gets the size of one observation, to check a binding's
+//              layout against the library's
+// return: int, SUBWAY_OBSERVATION_FLOATS
+// precondition: none
+// postcondition: none
+SUBWAY_API int subway_observation_floats(void);
+
+// description: starts a new run in one instance, or in all of them
+// return: void
+// precondition: instance < subway_instances(env); -1 resets every
+//               instance, instance i with seed + i
+// postcondition: the run is playing from its first tick, the same for
+//                the same seed and profile, and its observation is
+//                filled
+SUBWAY_API void subway_reset(SubwayEnv* env, int instance, unsigned seed);
+
+// description: advances every instance by one tick
+// return: void
+// precondition: actions holds one SUBWAY_ACTION_* per instance; rewards
+//               and dones hold one slot per instance, or are NULL
+// postcondition: each running instance took its action and ticked;
+//                rewards[i] is the score it gained, dones[i] is 1 once
+//                its run is over. A finished instance stands still
+//                (reward 0, done 1) until it is reset. Observations
+//                updated in place.
+SUBWAY_API void subway_step(SubwayEnv* env, const int32_t* actions, float* rewards, uint8_t* dones);
+
+// description: gets the observation buffer
+// return: const SubwayObservation*, one per instance, in instance order
+// precondition: env valid
+// postcondition: the pointer stays valid, and the buffer is rewritten
+//                by every reset and step, until subway_destroy
+SUBWAY_API const SubwayObservation* subway_observations(const SubwayEnv* env);
+
+// description: hashes everything that decides how an instance plays on
+//              (player, objects, score, timers and random generator), to
+//              check that runs meant to be the same, on other threads,
+//              processes or machines, really are
+// return: uint64_t, equal for instances in the same state
+// precondition: 0 <= instance < subway_instances(env)
+// postcondition: none
+SUBWAY_API uint64_t subway_state_hash(const SubwayEnv* env, int instance);
+
+// description: gets the size of a downsampled frame
+// return: void
+// precondition: factor >= 1
+// postcondition: width and height set to the screen size over factor
+SUBWAY_API void subway_frame_size(int factor, int* width, int* height);
+
+// description: draws one instance the way the game shows it, averaging
+//              each factor x factor block of the screen into one pixel
+//              written straight into the caller's memory
+// return: int, 0 on success, -1 if env was made without SUBWAY_RENDER,
+//         instance is out of range or factor < 1
+// precondition: pixels holds the width * height of subway_frame_size
+// postcondition: pixels holds the frame as opaque ARGB8888, row by row
+SUBWAY_API int subway_render(SubwayEnv* env, int instance, int factor, uint32_t* pixels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,183 @@
+#include "Telemetry.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+// How often the resident set size is read; reading it is a system call
+const Uint32 RSS_SAMPLE_MS = 1000;
+
+// Reads the resident set size without touching the global allocator
+static size_t sampleRss() {
+#if defined(__linux__)
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    unsigned long pages = 0, resident = 0;
+    int read = std::fscanf(statm, "%lu %lu", &pages, &resident);
+    std::fclose(statm);
+    return read == 2 ? resident * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+#else
+    return 0;
+#endif
+}
+
+static AllocationCount sum(const AllocationCount (&counts)[SUBSYSTEM_COUNT]) {
+    AllocationCount total;
+    total.count = 0;
+    total.bytes = 0;
+    for (const AllocationCount& c : counts) {
+        total.count += c.count;
+        total.bytes += c.bytes;
+    }
+    return total;
+}
+
+const char* containerName(Container container) {
+    switch (container) {
+        case Container::Obstacles:
+            return "obstacles";
+        case Container::Collectibles:
+            return "collectibles";
+        case Container::Particles:
+            return "particles";
+        default:
+            return "frame arena";
+    }
+}
+
+Telemetry::Telemetry()
+    : frames(0),
+      framesSinceLog(0),
+      firstSteadyAllocation(0),
+      rssBytes(0),
+      peakRssBytes(0),
+      lastRssSample(0),
+      lastLog(0),
+      logInterval(0) {
+    for (int s = 0; s < SUBSYSTEM_COUNT; s++) {
+        previous[s] = allocationCount(static_cast<Subsystem>(s));
+        lastFrame[s] = sinceLog[s] = steady[s] = AllocationCount{0, 0};
+    }
+    for (ContainerStat& c : containers) {
+        c = ContainerStat{0, 0, 0};
+    }
+}
+
+void Telemetry::setLogInterval(Uint32 ms) {
+    logInterval = ms;
+}
+
+void Telemetry::sampleContainer(Container container, size_t size, size_t capacity) {
+    ContainerStat& c = containers[static_cast<int>(container)];
+    c.size = size;
+    c.highWater = std::max(c.highWater, size);
+    c.capacity = capacity;
+}
+
+void Telemetry::endFrame(Uint32 now) {
+    frames++;
+    framesSinceLog++;
+    bool warm = frames > TELEMETRY_WARMUP_FRAMES;
+
+    for (int s = 0; s < SUBSYSTEM_COUNT; s++) {
+        AllocationCount total = allocationCount(static_cast<Subsystem>(s));
+        lastFrame[s].count = total.count - previous[s].count;
+        lastFrame[s].bytes = total.bytes - previous[s].bytes;
+        previous[s] = total;
+
+        sinceLog[s].count += lastFrame[s].count;
+        sinceLog[s].bytes += lastFrame[s].bytes;
+        if (warm) {
+            steady[s].count += lastFrame[s].count;
+            steady[s].bytes += lastFrame[s].bytes;
+            if (lastFrame[s].count > 0 && firstSteadyAllocation == 0) {
+                firstSteadyAllocation = frames;
+            }
+        }
+    }
+
+    if (frames == 1 || now - lastRssSample >= RSS_SAMPLE_MS) {
+        rssBytes = sampleRss();
+        peakRssBytes = std::max(peakRssBytes, rssBytes);
+        lastRssSample = now;
+    }
+
+    if (frames == 1) {
+        lastLog = now;
+    } else if (logInterval > 0 && now - lastLog >= logInterval) {
+        log();
+        lastLog = now;
+    }
+}
+
+AllocationCount Telemetry::getFrameAllocations(Subsystem subsystem) const {
+    return lastFrame[static_cast<int>(subsystem)];
+}
+
+AllocationCount Telemetry::getFrameAllocations() const {
+    return sum(lastFrame);
+}
+
+AllocationCount Telemetry::getSteadyAllocations(Subsystem subsystem) const {
+    return steady[static_cast<int>(subsystem)];
+}
+
+AllocationCount Telemetry::getSteadyAllocations() const {
+    return sum(steady);
+}
+
+unsigned long long Telemetry::getSteadyFrames() const {
+    return frames > TELEMETRY_WARMUP_FRAMES ? frames - TELEMETRY_WARMUP_FRAMES : 0;
+}
+
+unsigned long long Telemetry::getFirstSteadyAllocation() const {
+    return firstSteadyAllocation;
+}
+
+const ContainerStat& Telemetry::getContainer(Container container) const {
+    return containers[static_cast<int>(container)];
+}
+
+size_t Telemetry::getRss() const {
+    return rssBytes;
+}
+
+void Telemetry::log() {
+    std::printf("telemetry: %llu frames", framesSinceLog);
+    if (allocationCountingEnabled()) {
+        AllocationCount total = sum(sinceLog);
+        std::printf(", %llu allocations (%llu bytes) [", total.count, total.bytes);
+        for (int s = 0; s < SUBSYSTEM_COUNT; s++) {
+            std::printf("%s%s %llu", s > 0 ? ", " : "", subsystemName(static_cast<Subsystem>(s)),
+                        sinceLog[s].count);
+        }
+        std::printf("]");
+    }
+    for (int c = 0; c < CONTAINER_COUNT; c++) {
+        const ContainerStat& stat = containers[c];
+        std::printf(", %s %zu (peak %zu/%zu)", containerName(static_cast<Container>(c)), stat.size,
+                    stat.highWater, stat.capacity);
+    }
+    if (rssBytes > 0) {
+        std::printf(", rss %.1f MB (peak %.1f MB)", rssBytes / 1048576.0, peakRssBytes / 1048576.0);
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+
+    framesSinceLog = 0;
+    for (AllocationCount& c : sinceLog) {
+        c = AllocationCount{0, 0};
+    }
+}
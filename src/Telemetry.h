@@ -0,0 +1,136 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+
+#include "AllocationCounter.h"
+
+// Containers whose fill level is tracked. FrameArena is measured in
+// bytes, the others in elements.
+enum class Container { Obstacles, Collectibles, Particles, FrameArena };
+const int CONTAINER_COUNT = 4;
+
+// Fill level of one container: now, the most it has held, and what it
+// can hold before it has to grow
+struct ContainerStat {
+    size_t size;
+    size_t highWater;
+    size_t capacity;
+};
+
+// Frames played before allocations count as steady state
+const unsigned TELEMETRY_WARMUP_FRAMES = 60;
+
+// Per-frame memory statistics: allocations per subsystem (in builds with
+// allocation counting), container high-water marks and resident set
+// size. Fed once per frame by the main loop; read by the overlay, the
+// periodic log line and the headless steady-state check.
+class Telemetry {
+   private:
+    AllocationCount previous[SUBSYSTEM_COUNT];   // running totals as of the last frame
+    AllocationCount lastFrame[SUBSYSTEM_COUNT];  // made during the last frame
+    AllocationCount sinceLog[SUBSYSTEM_COUNT];   // made since the last log line
+    AllocationCount steady[SUBSYSTEM_COUNT];     // made after the warmup
+    unsigned long long frames;
+    unsigned long long framesSinceLog;
+    unsigned long long firstSteadyAllocation;  // frame number, 0 if none
+    ContainerStat containers[CONTAINER_COUNT];
+    size_t rssBytes;
+    size_t peakRssBytes;
+    Uint32 lastRssSample;
+    Uint32 lastLog;
+    Uint32 logInterval;
+
+   public:
+    // description: starts counting from the current allocation totals
+    // return: N/A (constructor)
+    // precondition: none
+    // postcondition: no frames recorded; logging off
+    Telemetry();
+
+    // description: turns the periodic log line on or off
+    // return: void
+    // precondition: none
+    // postcondition: a line is printed every ms of frame time; 0 is off
+    void setLogInterval(Uint32 ms);
+
+    // description: records a container's current fill level
+    // return: void
+    // precondition: called between frames, before endFrame
+    // postcondition: size stored, high-water mark raised if needed
+    void sampleContainer(Container container, size_t size, size_t capacity);
+
+    // description: closes a frame: takes the allocations made since the
+    //              last call, samples RSS about once a second, and logs
+    //              when the interval has passed
+    // return: void
+    // precondition: now is the frame's time in ms (SDL ticks, or
+    //               simulated time in headless runs)
+    // postcondition: frame statistics updated
+    void endFrame(Uint32 now);
+
+    // description: gets what one subsystem allocated in the last frame
+    // return: AllocationCount
+    // precondition: none
+    // postcondition: none
+    AllocationCount getFrameAllocations(Subsystem subsystem) const;
+
+    // description: gets what all subsystems allocated in the last frame
+    // return: AllocationCount
+    // precondition: none
+    // postcondition: none
+    AllocationCount getFrameAllocations() const;
+
+    // description: gets what one subsystem allocated after the warmup
+    // return: AllocationCount
+    // precondition: none
+    // postcondition: none
+    AllocationCount getSteadyAllocations(Subsystem subsystem) const;
+
+    // description: gets what all subsystems allocated after the warmup
+    // return: AllocationCount
+    // precondition: none
+    // postcondition: none
+    AllocationCount getSteadyAllocations() const;
+
+    // description: gets the number of frames after the warmup
+    // return: unsigned long long
+    // precondition: none
+    // postcondition: none
+    unsigned long long getSteadyFrames() const;
+
+    // description: gets the first frame after the warmup that allocated
+    // return: unsigned long long (1-based frame number, 0 if none did)
+    // precondition: none
+    // postcondition: none
+    unsigned long long getFirstSteadyAllocation() const;
+
+    // description: gets a container's fill level
+    // return: const ContainerStat&
+    // precondition: none
+    // postcondition: none
+    const ContainerStat& getContainer(Container container) const;
+
+    // description: gets the last resident set size sample
+    // return: size_t bytes (0 where the platform has no way to read it)
+    // precondition: none
+    // postcondition: none
+    size_t getRss() const;
+
+    // description: prints one line summarizing the frames since the last
+    //              line
+    // return: void
+    // precondition: none
+    // postcondition: per-interval allocation totals cleared
+    void log();
+};
+
+// description: names a container for reports
+// return: const char* (lower case)
+// precondition: none
+// postcondition: none
+const char* containerName(Container container);
+
+#endif
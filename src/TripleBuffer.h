@@ -0,0 +1,92 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// Lock-free handoff of the latest value from one producer thread to one
+// consumer thread. The producer fills the back slot and publishes it; the
+// consumer takes the newest published slot as its front. The third slot
+// sits between them, so neither side ever waits for the other or sees a
+// slot the other is using. Values published faster than they are taken
+// replace each other; a producer that needs every value taken waits for
+// the last one to go before publishing the next.
+template <typename T>
+class TripleBuffer {
+   private:
+    static const unsigned INDEX_MASK = 3;
+    static const unsigned FRESH = 4;  // middle holds a value not yet taken
+
+    T slots[3];
+    std::atomic<unsigned> middle;  // slot index, plus FRESH
+    unsigned back;                 // producer's slot
+    unsigned front;                // consumer's slot
+
+   public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    // description: gets the slot the producer fills next
+    // return: T& (holds whatever was in the slot before, for reuse)
+    // precondition: called from the producer thread only
+    // postcondition: none
+    T& writeSlot() {
+        return slots[back];
+    }
+
+    // description: hands the filled back slot to the consumer
+    // return: void
+    // precondition: called from the producer thread only
+    // postcondition: the slot is the newest value; writeSlot moves on to
+    //                another slot
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+        middle.notify_one();
+    }
+
+    // description: blocks until the last published value has been taken
+    //              (producer side)
+    // return: void
+    // precondition: called from the producer thread only
+    // postcondition: publish will not replace an untaken value
+    void waitUntilTaken() const {
+        unsigned m = middle.load(std::memory_order_acquire);
+        while ((m & FRESH) != 0) {
+            middle.wait(m, std::memory_order_acquire);
+            m = middle.load(std::memory_order_acquire);
+        }
+    }
+
+    // description: blocks until there is a value the consumer has not
+    //              taken (consumer side)
+    // return: void
+    // precondition: called from the consumer thread only
+    // postcondition: acquire will return true
+    void waitUntilPublished() const {
+        unsigned m = middle.load(std::memory_order_acquire);
+        while ((m & FRESH) == 0) {
+            middle.wait(m, std::memory_order_acquire);
+            m = middle.load(std::memory_order_acquire);
+        }
+    }
+
+    // description: takes the newest published value, if there is one
+    //              the consumer has not seen (consumer side)
+    // return: bool, false if nothing new was published
+    // precondition: called from the consumer thread only
+    // postcondition: readSlot holds the newest value if true
+    bool acquire() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        middle.notify_one();
+        return true;
+    }
+
+    // description: gets the value the consumer took last
+    // return: const T&
+    // precondition: called from the consumer thread only
+    // postcondition: none
+    const T& readSlot() const {
+        return slots[front];
+    }
+};
+
+#endif
@@ -1,38 +1,340 @@
-#include <SDL2/SDL_mixer.h>
-
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
+#include <memory>
 
+#include "AllocationCounter.h"
+#include "Audio.h"
+#include "Autopilot.h"
+#include "Config.h"
 #include "Constants.h"
 #include "Game.h"
+#include "LatencyProbe.h"
+#include "Replay.h"
 #include "SDL_Plotter.h"
+#include "SimulationThread.h"
+#include "StartupTrace.h"
+#include "Telemetry.h"
+
+// Assets are read from the archive next to the executable, or from loose
+// files under assets/ there when it has not been built
+const char* const ASSET_ARCHIVE = "assets.pak";
+const char* const MUSIC_ASSET = "memphis-trap-wav-349366.mp3";
+
+// Longest an idle loop sleeps without an event; only a safety net, since
+// input and the music loader both wake it
+const int IDLE_WAIT_MS = 500;
+
+// Interval of the --telemetry log line
+const Uint32 TELEMETRY_LOG_MS = 5000;
+
+// Length of a headless autopilot run unless --ticks says otherwise
+const Uint32 AUTOPILOT_BENCH_TICKS = 60000 / TICK_MS;
+
+// Plays a replay back as fast as the machine allows: one rendered frame
+// per tick, no audio and no sleeping. The simulation thread runs each
+// tick while the previous one is drawn here, so a run takes about as
+// long as the slower of the two. Drives the profile-guided optimization
+// training run. With an autopilot the replay is empty and only sets the
+// length, and the run measures the autopilot's search along with the
+// game. Returns the exit code: 1 when assertNoAlloc is set and the game
+// allocated after the warmup.
+static int runHeadless(SDL_Plotter& g, SubwaySurferGame& game, Replay& replay, Autopilot* autopilot,
+                       Telemetry& telemetry, bool assertNoAlloc) {
+    InputQueue input;
+    TripleBuffer<GameSnapshot> snapshots;
+    SimulationThread sim(game, snapshots, input, input, replay, SimulationMode::Headless);
+    sim.setAutopilot(autopilot);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // The simulation publishes every tick of the replay, each only once
+    // the one before has been taken
+    sim.start();
+    for (Uint32 frames = 0; frames < replay.length; frames++) {
+        snapshots.waitUntilPublished();
+        snapshots.acquire();
+        const GameSnapshot& frame = snapshots.readSlot();
+        game.render(frame);
+        g.update();
+        game.sampleTelemetry(frame, telemetry);
+        telemetry.endFrame(frame.tickEnd);
+        if (g.getQuit()) break;
+    }
+    sim.stop();
+    Uint32 tick = sim.getTick();
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%s: %u ticks in %.1f ms (%.0f ticks/s), final score %d\n", autopilot ? "autopilot" : "replay",
+                tick, ms, ms > 0 ? tick * 1000.0 / ms : 0.0, game.getScore());
+    if (autopilot != nullptr) {
+        autopilot->report();
+    }
+    if (!allocationCountingEnabled() || telemetry.getSteadyFrames() == 0) return 0;
+
+    // Allocations count from the end of the warmup, once the containers
+    // have reached their working size
+    AllocationCount steady = telemetry.getSteadyAllocations();
+    std::printf("allocations: %llu (%llu bytes) in %llu steady-state ticks\n", steady.count, steady.bytes,
+                telemetry.getSteadyFrames());
+    if (steady.count == 0) return 0;
+
+    std::printf("  first in tick %llu\n", telemetry.getFirstSteadyAllocation() - 1);
+    for (int s = 0; s < SUBSYSTEM_COUNT; s++) {
+        AllocationCount c = telemetry.getSteadyAllocations(static_cast<Subsystem>(s));
+        if (c.count > 0) {
+            std::printf("  %s: %llu (%llu bytes)\n", subsystemName(static_cast<Subsystem>(s)), c.count, c.bytes);
+        }
+    }
+    if (assertNoAlloc) {
+        std::cout << "Telemetry Error: " << steady.count << " allocations after the warmup" << std::endl;
+        return 1;
+    }
+    return 0;
+}
 
 int main(int argc, char** argv) {
-    // Initialize SDL_mixer for audio
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
-        std::cout << "SDL_mixer Error: " << Mix_GetError() << std::endl;
+    bool traceStartup = false;
+    bool headless = false;
+    bool telemetryLog = false;
+    bool assertNoAlloc = false;
+    bool probeLatency = false;
+    bool autopilotOn = false;
+    bool recordHashes = false;
+    bool verify = false;
+    int autopilotThreads = 0;
+    Uint32 benchTicks = AUTOPILOT_BENCH_TICKS;
+    PresentMode presentMode = PresentMode::Accelerated;
+    const char* profilePath = nullptr;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    unsigned seed = (unsigned)time(NULL);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--startup-trace") == 0) {
+            traceStartup = true;
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (strcmp(argv[i], "--telemetry") == 0) {
+            telemetryLog = true;
+        } else if (strcmp(argv[i], "--assert-no-alloc") == 0) {
+            assertNoAlloc = true;
+        } else if (strcmp(argv[i], "--latency-probe") == 0) {
+            probeLatency = true;
+        } else if (strcmp(argv[i], "--autopilot") == 0) {
+            autopilotOn = true;
+        } else if (strcmp(argv[i], "--autopilot-threads") == 0 && i + 1 < argc) {
+            autopilotThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            benchTicks = (Uint32)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--present") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (!parsePresentMode(name, presentMode)) {
+                std::cout << "Present Error: unknown mode " << name
+                          << " (vsync, adaptive, software, accelerated or uncapped;"
+                          << " each draws at most one frame per " << TICK_MS << " ms tick)" << std::endl;
+            }
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--record-hashes") == 0) {
+            recordHashes = true;
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--verify-replay") == 0 && i + 1 < argc) {
+            // A headless replay that has to match its recorded hashes
+            replayPath = argv[++i];
+            headless = true;
+            verify = true;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        }
+    }
+    StartupTrace trace(traceStartup);
+
+    // Gameplay tunables: built-in defaults, optionally overridden by
+    // --profile <file>
+    GameConfig config;
+    if (profilePath != nullptr && !loadConfigProfile(profilePath, config)) {
+        std::cout << "Profile had errors; invalid entries were ignored" << std::endl;
+    }
+
+    // A replay brings its own seed; a recording stores the one in use.
+    // Either way the session has to be run with the same profile.
+    Replay replay;
+    if (autopilotOn && replayPath != nullptr) {
+        std::cout << "Autopilot Error: --autopilot plays live; it cannot be combined with --replay" << std::endl;
+        return 1;
+    }
+    if (replayPath != nullptr) {
+        if (!replay.load(replayPath)) return 1;
+        seed = replay.seed;
+        if (verify && replay.hashes.empty()) {
+            std::cout << "Replay Error: " << replayPath
+                      << " has no state hashes to verify; record it with --record-hashes" << std::endl;
+            return 1;
+        }
+    } else if (headless && autopilotOn) {
+        replay.length = benchTicks;
+    } else if (headless) {
+        std::cout << "Headless Error: --headless needs --replay <file> or --autopilot" << std::endl;
+        return 1;
+    }
+    if (recordHashes && recordPath == nullptr) {
+        std::cout << "Replay Error: --record-hashes needs --record <file>; ignored" << std::endl;
+        recordHashes = false;
+    }
+    replay.recordHashes = recordHashes;
+    if (assertNoAlloc && (!headless || !allocationCountingEnabled())) {
+        std::cout << "Headless Error: --assert-no-alloc needs --headless and a build with allocation counting"
+                  << std::endl;
+        return 1;
+    }
+    if (probeLatency && replayPath != nullptr) {
+        // Replayed keys carry the tick they were recorded on, not a
+        // time they reached SDL
+        std::cout << "Latency Error: --latency-probe measures live input; ignored with --replay" << std::endl;
+        probeLatency = false;
+    }
+    if (probeLatency && autopilotOn) {
+        std::cout << "Latency Error: --latency-probe measures live input; ignored with --autopilot" << std::endl;
+        probeLatency = false;
+    }
+    replay.seed = seed;
+    trace.mark("config");
+
+    // Headless runs draw into a framebuffer that is never shown
+    if (headless) {
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    }
+
+    // Create the plotter, the asset archive, the audio context and the
+    // game, in that order so they are torn down in reverse.
+    SDL_Plotter g(SCREEN_HEIGHT, SCREEN_WIDTH, true, presentMode, FRAME_GUARD, FRAME_GUARD);
+    trace.mark("window and framebuffer");
+    AssetArchive assets;
+    assets.open(pathNextToExecutable(ASSET_ARCHIVE));
+    trace.mark("asset archive");
+    AudioContext audio;
+    SubwaySurferGame game(g, config, seed);
+    Telemetry telemetry;
+    if (telemetryLog) {
+        telemetry.setLogInterval(TELEMETRY_LOG_MS);
     }
+    game.setTelemetry(&telemetry);
+    LatencyProbe latency(probeLatency);
+    game.setLatencyProbe(&latency);
+    std::unique_ptr<Autopilot> autopilot;
+    if (autopilotOn) {
+        autopilot = std::make_unique<Autopilot>(config, autopilotThreads);
+    }
+    trace.mark("game");
 
-    // Initialize the font
-    initializeFont();
+    // Only the start screen is needed for the first frame; put it up
+    // before anything else.
+    GameSnapshot startFrame;
+    game.writeSnapshot(startFrame);
+    game.render(startFrame);
+    g.update();
+    trace.mark("first frame presented");
 
-    // Create the plotter and game
-    SDL_Plotter g(SCREEN_HEIGHT, SCREEN_WIDTH);
-    SubwaySurferGame game(g);
+    if (headless) {
+        int status = runHeadless(g, game, replay, autopilot.get(), telemetry, assertNoAlloc);
+        if (!replay.hashes.empty() && !replay.reportCheck(replayPath)) {
+            status = 1;
+        }
+        return status;
+    }
 
-    // Main game loop
+    // Then the audio: the device opens now, the music loads and decodes
+    // on a background thread while the start screen takes input.
+    if (audio.open(config.audioBufferSize)) {
+        audio.loadMusicAsync(assets.openAsset(MUSIC_ASSET));
+    }
+    trace.mark("audio device");
+    game.loadSounds(assets);
+    trace.mark("sound effects");
+
+    // Key presses go into a timestamped queue that the game drains
+    // tick by tick. While recording they pass through the recorder on
+    // the way; while replaying, live input is ignored. Under the autopilot
+    // the simulation thread forwards them itself.
+    InputQueue input;
+    InputQueue live;
+    if (recordPath != nullptr || autopilot) {
+        g.setInputQueue(&live);
+    } else if (replayPath == nullptr) {
+        g.setInputQueue(&input);
+    }
+
+    // Main game loop: the simulation runs in fixed ticks on its own
+    // thread (see SimulationThread) while this one pumps events and draws
+    // the newest snapshot it publishes.
+    TripleBuffer<GameSnapshot> snapshots;
+    SimulationMode mode = recordPath != nullptr   ? SimulationMode::Record
+                          : replayPath != nullptr ? SimulationMode::Replay
+                                                  : SimulationMode::Live;
+    SimulationThread sim(game, snapshots, input, live, replay, mode);
+    sim.setAutopilot(autopilot.get());
+    sim.start();
+    Uint32 frameDue = SDL_GetTicks();
     while (!g.getQuit()) {
-        char key = '\0';
-        if (g.kbhit()) {
-            key = g.getKey();
+        sim.wake();
+        if (audio.update()) {
+            trace.mark("music ready");
         }
 
-        game.update(key);
-        game.render();
-        g.update();
-        g.Sleep(16);
+        // Read before acquiring: whatever the simulation published before
+        // going idle or finishing is then sure to be seen
+        bool idle = sim.isIdle();
+        bool finished = sim.isFinished();
+        if (snapshots.acquire()) {
+            const GameSnapshot& frame = snapshots.readSlot();
+            game.render(frame);
+            g.update();
+            latency.framePresented(SDL_GetTicks(), frame.tickEnd);
+            game.sampleTelemetry(frame, telemetry);
+            telemetry.endFrame(SDL_GetTicks());
+            frameDue = frame.tickEnd;
+        } else if (finished) {
+            break;
+        } else if (idle) {
+            // The start, pause and game-over screens stand still until
+            // input arrives. Block in SDL instead of drawing the same
+            // frame again; the next event wakes the loop and, through
+            // wake, the simulation.
+            if (g.takeExposed()) {
+                g.update();
+            }
+            g.waitEvent(IDLE_WAIT_MS);
+        } else {
+            // Pacing: the next snapshot is due when the simulation's next
+            // tick ends. Wait for it in SDL rather than sleeping, so an
+            // event arriving meanwhile is pumped at once and reaches the
+            // simulation before the tick it belongs to. A vsynced present
+            // has usually used up the wait already. Uncapped polls every
+            // millisecond instead, so a snapshot is presented within a
+            // millisecond of being published; there is one new snapshot
+            // per tick, so it is still capped at the tick rate.
+            Sint32 wait = (Sint32)(frameDue - SDL_GetTicks());
+            g.waitEvent(wait > 0 && presentMode != PresentMode::Uncapped ? wait : 1);
+        }
+    }
+    sim.stop();
+
+    latency.report(presentModeName(presentMode));
+    if (autopilot) {
+        autopilot->report();
+    }
+
+    if (replayPath != nullptr && !replay.hashes.empty()) {
+        replay.reportCheck(replayPath);
+    }
+    if (recordPath != nullptr && replay.save(recordPath)) {
+        std::cout << "Recorded " << replay.length << " ticks to " << recordPath << std::endl;
     }
 
-    // Cleanup
-    Mix_CloseAudio();
     return 0;
 }
\ No newline at end of file
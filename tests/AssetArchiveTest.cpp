@@ -0,0 +1,145 @@
+// Checks that AssetArchive finds what an archive holds and refuses
+// archives whose header or index would send it outside the file.
+//
+//     make test
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AssetArchive.h"
+#include "Check.h"
+
+namespace {
+
+const char* const NAMES[] = {"images/coin.png", "sounds/jump.wav", "sounds/music.ogg"};
+const int ASSET_COUNT = 3;
+
+// description: builds an archive the way the packer lays one out: three
+//              assets, each holding its own name
+// return: vector of the archive's bytes
+// precondition: none
+// postcondition: none
+std::vector<unsigned char> buildArchive() {
+    size_t dataStart = sizeof(PakHeader) + ASSET_COUNT * sizeof(PakEntry);
+    std::vector<unsigned char> bytes(dataStart);
+
+    PakHeader header = {};
+    std::memcpy(header.magic, PAK_MAGIC, sizeof(PAK_MAGIC));
+    header.version = PAK_VERSION;
+    header.count = ASSET_COUNT;
+    std::memcpy(&bytes[0], &header, sizeof(header));
+
+    for (int i = 0; i < ASSET_COUNT; i++) {
+        while (bytes.size() % PAK_ALIGNMENT != 0) bytes.push_back(0);
+        PakEntry entry = {};
+        std::strncpy(entry.name, NAMES[i], PAK_NAME_LENGTH - 1);
+        entry.offset = (uint32_t)bytes.size();
+        entry.size = (uint32_t)std::strlen(NAMES[i]);
+        std::memcpy(&bytes[sizeof(PakHeader) + i * sizeof(PakEntry)], &entry, sizeof(entry));
+        bytes.insert(bytes.end(), NAMES[i], NAMES[i] + entry.size);
+    }
+    return bytes;
+}
+
+PakEntry* entryAt(std::vector<unsigned char>& bytes, int i) {
+    return (PakEntry*)&bytes[sizeof(PakHeader) + i * sizeof(PakEntry)];
+}
+
+// Writes the bytes to a scratch file in the working directory (the build
+// tree under ctest) and opens that
+bool openBytes(AssetArchive& archive, const std::vector<unsigned char>& bytes) {
+    std::string path = "subway_asset_test.pak";
+    {
+        std::ofstream file(path.c_str(), std::ios::binary);
+        file.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+    }
+    bool opened = archive.open(path);
+    std::remove(path.c_str());
+    return opened;
+}
+
+void checkValidArchive() {
+    AssetArchive archive;
+    CHECK(!archive.isOpen());
+    CHECK(openBytes(archive, buildArchive()));
+    CHECK(archive.isOpen());
+
+    for (int i = 0; i < ASSET_COUNT; i++) {
+        const void* bytes = nullptr;
+        size_t length = 0;
+        CHECK(archive.find(NAMES[i], bytes, length));
+        CHECK_EQ(length, std::strlen(NAMES[i]));
+        CHECK(bytes != nullptr && std::memcmp(bytes, NAMES[i], length) == 0);
+        CHECK((size_t)bytes % PAK_ALIGNMENT == 0);
+    }
+
+    const void* bytes = nullptr;
+    size_t length = 0;
+    CHECK(!archive.find("images/missing.png", bytes, length));
+    CHECK(!archive.find("", bytes, length));
+}
+
+void checkInvalidArchives() {
+    AssetArchive archive;
+
+    std::vector<unsigned char> bytes = buildArchive();
+    bytes[0] = 'X';
+    CHECK(!openBytes(archive, bytes));
+    CHECK(!archive.isOpen());
+
+    bytes = buildArchive();
+    ((PakHeader*)&bytes[0])->version = PAK_VERSION + 1;
+    CHECK(!openBytes(archive, bytes));
+
+    // An index longer than the file
+    bytes = buildArchive();
+    ((PakHeader*)&bytes[0])->count = 1000000;
+    CHECK(!openBytes(archive, bytes));
+
+    // Cut off in the middle of the index
+    bytes = buildArchive();
+    bytes.resize(sizeof(PakHeader) + sizeof(PakEntry) / 2);
+    CHECK(!openBytes(archive, bytes));
+
+    // Cut off inside the last asset
+    bytes = buildArchive();
+    bytes.pop_back();
+    CHECK(!openBytes(archive, bytes));
+
+    // An entry pointing past the end, and one whose size wraps around
+    bytes = buildArchive();
+    entryAt(bytes, 1)->offset = (uint32_t)bytes.size() + 1;
+    CHECK(!openBytes(archive, bytes));
+    bytes = buildArchive();
+    entryAt(bytes, 1)->size = 0xFFFFFFF0u;
+    CHECK(!openBytes(archive, bytes));
+
+    // A name with no terminator
+    bytes = buildArchive();
+    std::memset(entryAt(bytes, 2)->name, 'a', PAK_NAME_LENGTH);
+    CHECK(!openBytes(archive, bytes));
+
+    // An index out of order, and one naming an asset twice
+    bytes = buildArchive();
+    std::swap(*entryAt(bytes, 0), *entryAt(bytes, 2));
+    CHECK(!openBytes(archive, bytes));
+    bytes = buildArchive();
+    std::strncpy(entryAt(bytes, 2)->name, NAMES[1], PAK_NAME_LENGTH - 1);
+    CHECK(!openBytes(archive, bytes));
+
+    // Too short for a header
+    bytes.assign(4, 'S');
+    CHECK(!openBytes(archive, bytes));
+}
+
+}  // namespace
+
+int main() {
+    checkValidArchive();
+    checkInvalidArchives();
+    return checkResult("AssetArchiveTest");
+}
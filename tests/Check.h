@@ -0,0 +1,46 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+
+// The few checks the tests need. A failed check prints where it is and
+// what it tested, and the test carries on; checkResult turns the count of
+// failures into the exit status ctest and `make test` look at. Each test
+// is a single file, so the count can live here.
+
+static int checkFailures = 0;
+
+#define CHECK(condition)                                                                    \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition);      \
+            checkFailures++;                                                                \
+        }                                                                                   \
+    } while (0)
+
+// Compares two integers, printing both when they differ
+#define CHECK_EQ(actual, expected)                                                          \
+    do {                                                                                    \
+        long long checkActual = (long long)(actual);                                        \
+        long long checkExpected = (long long)(expected);                                    \
+        if (checkActual != checkExpected) {                                                 \
+            std::printf("%s:%d: CHECK_EQ failed: %s is %lld, expected %lld\n", __FILE__, __LINE__, \
+                        #actual, checkActual, checkExpected);                               \
+            checkFailures++;                                                                \
+        }                                                                                   \
+    } while (0)
+
+// description: reports a test executable's result
+// return: int, the exit status: 0 if every check passed, else 1
+// precondition: name is the test's name
+// postcondition: a one-line summary printed
+static int checkResult(const char* name) {
+    if (checkFailures == 0) {
+        std::printf("%s: all checks passed\n", name);
+        return 0;
+    }
+    std::printf("%s: %d checks failed\n", name, checkFailures);
+    return 1;
+}
+
+#endif
@@ -0,0 +1,86 @@
+// Checks profile loading: that every key lands in its field, that the
+// defaults stay for keys a profile leaves out, and that unknown keys and
+// values out of range (or an audio buffer that is not a power of two)
+// are refused without touching the config.
+//
+//     make test
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Check.h"
+#include "Config.h"
+
+namespace {
+
+// Scratch file, in the working directory (the build tree under ctest)
+const char* const PROFILE_PATH = "subway_config_test.profile";
+
+bool loadText(const char* text, GameConfig& config) {
+    {
+        std::ofstream file(PROFILE_PATH);
+        file << text;
+    }
+    bool loaded = loadConfigProfile(PROFILE_PATH, config);
+    std::remove(PROFILE_PATH);
+    return loaded;
+}
+
+void checkValidProfile() {
+    GameConfig defaults;
+    GameConfig config;
+    CHECK(loadText("# comment\n"
+                   "gravity = 1.5\n"
+                   "\n"
+                   "  jump_velocity=-8   # trailing comment\n"
+                   "obstacle_spawn_chance = 7\n"
+                   "audio_buffer_size = 512\n",
+                   config));
+    CHECK(config.gravity == 1.5f);
+    CHECK(config.jumpVelocity == -8.0f);
+    CHECK_EQ(config.obstacleSpawnChance, 7);
+    CHECK_EQ(config.audioBufferSize, 512);
+
+    // Keys left out keep their defaults
+    CHECK(config.baseScrollSpeed == defaults.baseScrollSpeed);
+    CHECK(config.levelSpeedStep == defaults.levelSpeedStep);
+    CHECK_EQ(config.collectibleSpawnChance, defaults.collectibleSpawnChance);
+    CHECK_EQ(config.heartSpawnChance, defaults.heartSpawnChance);
+    CHECK_EQ(config.heartRespawnChance, defaults.heartRespawnChance);
+}
+
+void checkBadProfiles() {
+    GameConfig defaults;
+    GameConfig config;
+
+    CHECK(!loadText("gravity_scale = 2\n", config));
+    CHECK(!loadText("gravity 2\n", config));
+    CHECK(!loadText("gravity = 9\n", config));
+    CHECK(!loadText("gravity = \n", config));
+    CHECK(!loadText("gravity = 0.5x\n", config));
+    CHECK(!loadText("obstacle_spawn_chance = 2.5\n", config));
+    CHECK(!loadText("heart_spawn_chance = 0\n", config));
+    CHECK(!loadText("audio_buffer_size = 16384\n", config));
+    CHECK(!loadText("audio_buffer_size = 1000\n", config));
+    CHECK(!loadText("audio_buffer_size = 1536\n", config));
+    CHECK(config.gravity == defaults.gravity);
+    CHECK_EQ(config.obstacleSpawnChance, defaults.obstacleSpawnChance);
+    CHECK_EQ(config.heartSpawnChance, defaults.heartSpawnChance);
+    CHECK_EQ(config.audioBufferSize, defaults.audioBufferSize);
+
+    // A bad line is reported, and the good lines around it still apply
+    CHECK(!loadText("level_speed_step = 1\nunknown = 1\nheart_respawn_chance = 20\n", config));
+    CHECK(config.levelSpeedStep == 1.0f);
+    CHECK_EQ(config.heartRespawnChance, 20);
+
+    CHECK(!loadConfigProfile(PROFILE_PATH, config));
+}
+
+}  // namespace
+
+int main() {
+    checkValidProfile();
+    checkBadProfiles();
+    return checkResult("ConfigTest");
+}
@@ -0,0 +1,90 @@
+// Checks the 16.16 fixed-point arithmetic the deterministic simulation
+// core is built on: conversions, rounding, wrapping and the sin table.
+//
+//     make test
+
+#include <cmath>
+#include <cstdint>
+
+#include "Check.h"
+#include "Fixed.h"
+
+namespace {
+
+void checkConversions() {
+    CHECK_EQ(Fixed(3).rawValue(), 3 * Fixed::ONE);
+    CHECK_EQ(Fixed(-2).rawValue(), -2 * Fixed::ONE);
+    CHECK_EQ(Fixed(0.5f).rawValue(), Fixed::ONE / 2);
+    CHECK_EQ(Fixed(-0.25f).rawValue(), -Fixed::ONE / 4);
+    // Rounds to nearest, halves away from zero
+    CHECK_EQ(Fixed(1.0f / 131072).rawValue(), 1);
+    CHECK_EQ(Fixed(-1.0f / 131072).rawValue(), -1);
+
+    // int conversion truncates toward zero, as a float's does
+    CHECK_EQ((int)Fixed(2.75f), 2);
+    CHECK_EQ((int)Fixed(-2.75f), -2);
+    CHECK((float)Fixed(1.5f) == 1.5f);
+}
+
+void checkArithmetic() {
+    CHECK(Fixed(2) + Fixed(3) == Fixed(5));
+    CHECK(Fixed(2) - Fixed(3) == Fixed(-1));
+    CHECK(Fixed(1.5f) * Fixed(4) == Fixed(6));
+    CHECK(Fixed(7) / Fixed(2) == Fixed(3.5f));
+    CHECK(Fixed(3) * 4 == Fixed(12));
+    CHECK(-Fixed(3) == Fixed(-3));
+    CHECK(Fixed(-1) < Fixed(0));
+    CHECK(Fixed(2.5f) > Fixed(2));
+
+    Fixed f = Fixed(1);
+    f += Fixed(2);
+    f *= Fixed(3);
+    f -= Fixed(1);
+    f /= Fixed(4);
+    CHECK(f == Fixed(2));
+}
+
+void checkRounding() {
+    // Products and quotients round toward minus infinity, whatever the signs
+    Fixed tiny = Fixed::fromRaw(1);
+    CHECK_EQ((tiny * Fixed(0.5f)).rawValue(), 0);
+    CHECK_EQ((-tiny * Fixed(0.5f)).rawValue(), -1);
+    CHECK_EQ((Fixed(1) / Fixed(3)).rawValue(), 21845);
+    CHECK_EQ((Fixed(-1) / Fixed(3)).rawValue(), -21846);
+    CHECK_EQ((Fixed(1) / Fixed(-3)).rawValue(), -21846);
+    CHECK_EQ((Fixed(-1) / Fixed(-3)).rawValue(), 21845);
+}
+
+void checkWrapping() {
+    // The ends of the range wrap instead of overflowing
+    Fixed largest = Fixed::fromRaw(INT32_MAX);
+    CHECK_EQ((largest + Fixed::fromRaw(1)).rawValue(), INT32_MIN);
+    CHECK_EQ((Fixed::fromRaw(INT32_MIN) - Fixed::fromRaw(1)).rawValue(), INT32_MAX);
+    CHECK_EQ((Fixed(20000) * 2).rawValue(), (int32_t)(uint32_t)(40000u * Fixed::ONE));
+    CHECK_EQ((Fixed(200) * Fixed(200)).rawValue(), (int32_t)(uint32_t)(40000u * Fixed::ONE));
+}
+
+void checkSinTable() {
+    CHECK(FIXED_SIN_DEGREES[0] == Fixed(0));
+    CHECK(FIXED_SIN_DEGREES[90] == Fixed(1));
+    CHECK(FIXED_SIN_DEGREES[270] == Fixed(-1));
+    int worst = 0;
+    for (int degrees = 0; degrees < 360; degrees++) {
+        double exact = std::sin(degrees * 3.14159265358979323846 / 180) * Fixed::ONE;
+        int error = (int)std::lround(std::fabs(FIXED_SIN_DEGREES[degrees].rawValue() - exact));
+        if (error > worst) worst = error;
+    }
+    // Within a step of the true value everywhere
+    CHECK(worst <= 1);
+}
+
+}  // namespace
+
+int main() {
+    checkConversions();
+    checkArithmetic();
+    checkRounding();
+    checkWrapping();
+    checkSinTable();
+    return checkResult("FixedTest");
+}
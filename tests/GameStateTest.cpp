@@ -0,0 +1,271 @@
+// Checks the simulation core in both its float and fixed-point builds:
+// the generator, swept collisions, that a copied state plays on exactly
+// as the original does, and the state hash replays rely on.
+//
+//     make test
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Check.h"
+#include "Config.h"
+#include "GameState.h"
+
+namespace {
+
+// description: starts a game with a single obstacle and no collectibles,
+//              the player in lane 1 on the ground, moving at speed
+// return: void
+// precondition: none
+// postcondition: state playing; sweeping on unless the player just
+//                changed lane
+template <class Scalar>
+void startWithObstacle(BasicGameState<Scalar>& state, const GameConfig& config, int y, int speed) {
+    state.reset(config, 1);
+    state.applyKey(config, ' ');
+    state.obstacleCount = 1;
+    state.collectibleCount = 0;
+    state.obstacles[0].lane = 1;
+    state.obstacles[0].y = Scalar(y);
+    state.obstacles[0].type = 0;
+    state.obstacles[0].active = true;
+    state.scrollSpeed = Scalar(speed);
+}
+
+// description: as startWithObstacle, with a single coin instead
+// return: void
+// precondition: none
+// postcondition: state playing
+template <class Scalar>
+void startWithCoin(BasicGameState<Scalar>& state, const GameConfig& config, int y, int speed) {
+    state.reset(config, 1);
+    state.applyKey(config, ' ');
+    state.obstacleCount = 0;
+    state.collectibleCount = 1;
+    state.collectibles[0].lane = 1;
+    state.collectibles[0].y = Scalar(y);
+    state.collectibles[0].type = 0;
+    state.collectibles[0].active = true;
+    state.collectibles[0].animTime = 0;
+    state.scrollSpeed = Scalar(speed);
+}
+
+void checkRngMatchesRand() {
+#if defined(__GLIBC__)
+    const unsigned seeds[] = {1, 9, 12345, 4000000000u};
+    for (unsigned seed : seeds) {
+        GameRng rng;
+        rng.seed(seed);
+        std::srand(seed);
+        bool same = true;
+        for (int i = 0; i < 1000; i++) {
+            if (rng.next() != std::rand()) same = false;
+        }
+        CHECK(same);
+    }
+
+    // Unseeded, both start as if seeded with 1
+    GameRng unseeded;
+    std::srand(1);
+    CHECK_EQ(unseeded.next(), std::rand());
+#endif
+}
+
+template <class Scalar>
+void checkSweptCollisions(const GameConfig& config) {
+    BasicGameState<Scalar> state;
+
+    // An obstacle moving 200 px a tick jumps from above the player to
+    // below in one tick; the sweep still catches it
+    startWithObstacle(state, config, PLAYER_Y_GROUND - 100, 200);
+    state.step(config);
+    CHECK_EQ(state.lives, START_LIVES - 1);
+
+    // One that ends the tick still above the player does not hit
+    startWithObstacle(state, config, PLAYER_Y_GROUND - 300, 200);
+    state.step(config);
+    CHECK_EQ(state.lives, START_LIVES);
+
+    // Changing into the lane does not sweep the part of the tick the
+    // player was not in it for
+    startWithObstacle(state, config, PLAYER_Y_GROUND - 100, 200);
+    state.tickLane = 0;
+    state.step(config);
+    CHECK_EQ(state.lives, START_LIVES);
+
+    // Coins are swept the same way
+    startWithCoin(state, config, PLAYER_Y_GROUND - 100, 200);
+    state.step(config);
+    CHECK_EQ(state.score, 10);
+    CHECK_EQ(state.comboMultiplier, 2);
+
+    // Faster than a screen a tick, an obstacle passes the player and
+    // leaves the screen in one move; it hits before it respawns
+    startWithObstacle(state, config, PLAYER_Y_GROUND - 100, 800);
+    state.step(config);
+    CHECK_EQ(state.lives, START_LIVES - 1);
+    CHECK(state.obstacles[0].y < 0);
+    CHECK_EQ(state.score, 0);
+
+    startWithCoin(state, config, PLAYER_Y_GROUND - 100, 800);
+    state.step(config);
+    CHECK_EQ(state.score, 10);
+
+    // One that leaves the screen without passing the player respawns
+    startWithObstacle(state, config, PLAYER_Y_GROUND + 200, 800);
+    state.step(config);
+    CHECK_EQ(state.lives, START_LIVES);
+    CHECK(state.obstacles[0].y < 0);
+    CHECK_EQ(state.score, 5);
+}
+
+// description: plays ticks ticks, moving or jumping every so often
+// return: void
+// precondition: state playing
+// postcondition: state advanced, or stopped at game over
+template <class Scalar>
+void play(BasicGameState<Scalar>& state, const GameConfig& config, int ticks) {
+    const char KEYS[] = {'a', 'w', 'd', 'd', 'w', 'a'};
+    for (int tick = 0; tick < ticks && state.gameState == STATE_PLAYING; tick++) {
+        if (tick % 37 == 0) state.applyKey(config, KEYS[(tick / 37) % 6]);
+        state.step(config);
+    }
+}
+
+template <class Scalar>
+bool sameState(const BasicGameState<Scalar>& a, const BasicGameState<Scalar>& b) {
+    bool same = a.gameState == b.gameState && a.currentLane == b.currentLane &&
+                a.playerY == b.playerY && a.verticalVelocity == b.verticalVelocity &&
+                a.score == b.score && a.lives == b.lives && a.level == b.level &&
+                a.scrollSpeed == b.scrollSpeed && a.obstacleCount == b.obstacleCount &&
+                a.collectibleCount == b.collectibleCount && a.particleCount == b.particleCount;
+    for (int i = 0; same && i < a.obstacleCount; i++) {
+        same = a.obstacles[i].lane == b.obstacles[i].lane && a.obstacles[i].y == b.obstacles[i].y &&
+               a.obstacles[i].active == b.obstacles[i].active;
+    }
+    for (int i = 0; same && i < a.collectibleCount; i++) {
+        same = a.collectibles[i].lane == b.collectibles[i].lane &&
+               a.collectibles[i].y == b.collectibles[i].y &&
+               a.collectibles[i].active == b.collectibles[i].active;
+    }
+    return same;
+}
+
+template <class Scalar>
+void checkCopyPlaysOn(const GameConfig& config) {
+    BasicGameState<Scalar> state;
+    state.reset(config, 7);
+    state.applyKey(config, ' ');
+    play(state, config, 200);
+    CHECK_EQ(state.gameState, STATE_PLAYING);
+
+    // The copy carries the generator along with everything else, so the
+    // two go on to spawn and score the same
+    BasicGameState<Scalar> copy;
+    state.copyTo(copy);
+    CHECK(sameState(copy, state));
+    play(state, config, 600);
+    play(copy, config, 600);
+    CHECK(sameState(copy, state));
+    CHECK_EQ(copy.rng.next(), state.rng.next());
+}
+
+template <class Scalar>
+void checkHash(const GameConfig& config) {
+    BasicGameState<Scalar> a;
+    BasicGameState<Scalar> b;
+    a.reset(config, 7);
+    b.reset(config, 7);
+    a.applyKey(config, ' ');
+    b.applyKey(config, ' ');
+    for (int tick = 0; tick < 100; tick++) {
+        if (tick == 10) {
+            a.applyKey(config, 'w');
+            b.applyKey(config, 'w');
+        }
+        a.step(config);
+        b.step(config);
+    }
+    CHECK(a.hash() == b.hash());
+
+    // A copy hashes the same, particles and all
+    BasicGameState<Scalar> copy;
+    a.copyTo(copy);
+    CHECK(copy.hash() == a.hash());
+
+    // A change shows up in its own field and no other
+    b.score++;
+    StateHash before = a.hash();
+    StateHash after = b.hash();
+    for (int field = 0; field < STATE_FIELD_COUNT; field++) {
+        bool differs = before.fields[field] != after.fields[field];
+        CHECK(differs == (field == (int)StateField::Progress));
+    }
+    CHECK(before.combined() != after.combined());
+
+    // So does a different seed
+    b.reset(config, 8);
+    a.reset(config, 7);
+    CHECK(a.hash().fields[(int)StateField::Rng] != b.hash().fields[(int)StateField::Rng]);
+}
+
+// description: runs a game at the top level for a long while
+// return: void
+// precondition: none
+// postcondition: state as it stands after ticks ticks past the level cap
+template <class Scalar>
+void runAtLevelCap(BasicGameState<Scalar>& state, const GameConfig& config, int ticks) {
+    state.reset(config, 3);
+    state.applyKey(config, ' ');
+    state.level = MAX_LEVEL - 10;
+    state.score = 2000000000;
+    state.lives = 1000000;
+    state.gameTime = Scalar(TIMER_PERIOD) - Scalar(0.01f);
+    state.animTime = Scalar(TIMER_PERIOD) - Scalar(0.01f);
+    for (int tick = 0; tick < ticks; tick++) {
+        state.step(config);
+    }
+}
+
+void checkRangeLimits() {
+    // Near where a fixed-point speed would wrap, both builds stop at the
+    // same level and speed
+    GameConfig fastest;
+    fastest.baseScrollSpeed = 50.0f;
+    fastest.levelSpeedStep = 10.0f;
+    for (const GameConfig& config : {GameConfig(), fastest}) {
+        BasicGameState<float> floating;
+        BasicGameState<Fixed> fixed;
+        runAtLevelCap(floating, config, 500);
+        runAtLevelCap(fixed, config, 500);
+
+        CHECK_EQ(floating.level, MAX_LEVEL);
+        CHECK_EQ(fixed.level, MAX_LEVEL);
+        float speed = config.baseScrollSpeed + MAX_LEVEL * config.levelSpeedStep;
+        CHECK(floating.scrollSpeed == std::min(speed, MAX_SCROLL_SPEED));
+        CHECK((float)fixed.scrollSpeed == floating.scrollSpeed);
+
+        // The clocks wrapped, and the instruction timer stopped
+        CHECK(floating.gameTime >= 0 && floating.gameTime < 10);
+        CHECK(fixed.gameTime >= 0 && fixed.gameTime < 10);
+        CHECK(floating.animTime >= 0 && floating.animTime < 10);
+        CHECK(fixed.animTime >= 0 && fixed.animTime < 10);
+        CHECK(floating.instructionTimer < INSTRUCTION_SECONDS + TICK_SECONDS);
+        CHECK(fixed.instructionTimer < Fixed(INSTRUCTION_SECONDS + TICK_SECONDS));
+    }
+}
+
+}  // namespace
+
+int main() {
+    GameConfig config;
+    checkRngMatchesRand();
+    checkSweptCollisions<float>(config);
+    checkSweptCollisions<Fixed>(config);
+    checkCopyPlaysOn<float>(config);
+    checkCopyPlaysOn<Fixed>(config);
+    checkHash<float>(config);
+    checkHash<Fixed>(config);
+    checkRangeLimits();
+    return checkResult("GameStateTest");
+}
@@ -0,0 +1,149 @@
+// Checks the lock-free handoffs between the threads: the SPSC input
+// queue and the triple buffer the frames go through.
+//
+//     make test
+
+#include <thread>
+
+#include "Check.h"
+#include "InputQueue.h"
+#include "TripleBuffer.h"
+
+namespace {
+
+const int THREADED_ITEMS = 200000;
+
+void checkQueueOrderAndCapacity() {
+    SpscQueue<int, 4> queue;
+    int item = -1;
+    CHECK(queue.empty());
+    CHECK(!queue.pop(item));
+    CHECK(!queue.peek(item));
+
+    for (int i = 0; i < 4; i++) CHECK(queue.push(i));
+    CHECK(!queue.push(99));  // full: dropped, not overwritten
+
+    CHECK(queue.peek(item));
+    CHECK_EQ(item, 0);
+    for (int i = 0; i < 4; i++) {
+        CHECK(queue.pop(item));
+        CHECK_EQ(item, i);
+    }
+    CHECK(queue.empty());
+}
+
+void checkQueueWrapsAround() {
+    SpscQueue<int, 4> queue;
+    int item = -1;
+    // Many more items than slots, so the indices wrap many times
+    for (int i = 0; i < 1000; i++) {
+        CHECK(queue.push(i));
+        CHECK(queue.push(i + 1));
+        CHECK(queue.pop(item));
+        CHECK_EQ(item, i);
+        CHECK(queue.pop(item));
+        CHECK_EQ(item, i + 1);
+    }
+    CHECK(queue.empty());
+}
+
+void checkQueueAcrossThreads() {
+    SpscQueue<int, 64> queue;
+    std::thread producer([&queue] {
+        for (int i = 0; i < THREADED_ITEMS; i++) {
+            while (!queue.push(i)) std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    int item = -1;
+    bool ordered = true;
+    while (expected < THREADED_ITEMS) {
+        if (!queue.pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (item != expected) ordered = false;
+        expected++;
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK(queue.empty());
+}
+
+void checkTripleBufferNewestWins() {
+    TripleBuffer<int> buffer;
+    CHECK(!buffer.acquire());
+
+    buffer.writeSlot() = 1;
+    buffer.publish();
+    buffer.writeSlot() = 2;
+    buffer.publish();
+    CHECK(buffer.acquire());
+    CHECK_EQ(buffer.readSlot(), 2);
+    CHECK(!buffer.acquire());  // nothing new since
+    CHECK_EQ(buffer.readSlot(), 2);
+
+    buffer.writeSlot() = 3;
+    buffer.publish();
+    CHECK(buffer.acquire());
+    CHECK_EQ(buffer.readSlot(), 3);
+}
+
+void checkTripleBufferLockstep() {
+    // With waitUntilTaken before each publish the consumer sees every
+    // value, in order
+    TripleBuffer<int> buffer;
+    std::thread producer([&buffer] {
+        for (int i = 1; i <= THREADED_ITEMS / 10; i++) {
+            buffer.waitUntilTaken();
+            buffer.writeSlot() = i;
+            buffer.publish();
+        }
+    });
+
+    bool ordered = true;
+    for (int i = 1; i <= THREADED_ITEMS / 10; i++) {
+        buffer.waitUntilPublished();
+        CHECK(buffer.acquire());
+        if (buffer.readSlot() != i) ordered = false;
+    }
+    producer.join();
+    CHECK(ordered);
+}
+
+void checkTripleBufferNeverGoesBack() {
+    // Without waiting, values may be skipped but never seen out of order
+    TripleBuffer<int> buffer;
+    std::thread producer([&buffer] {
+        for (int i = 1; i <= THREADED_ITEMS; i++) {
+            buffer.writeSlot() = i;
+            buffer.publish();
+        }
+    });
+
+    int last = 0;
+    bool increasing = true;
+    while (last < THREADED_ITEMS) {
+        if (!buffer.acquire()) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (buffer.readSlot() <= last) increasing = false;
+        last = buffer.readSlot();
+    }
+    producer.join();
+    CHECK(increasing);
+}
+
+}  // namespace
+
+int main() {
+    checkQueueOrderAndCapacity();
+    checkQueueWrapsAround();
+    checkQueueAcrossThreads();
+    checkTripleBufferNewestWins();
+    checkTripleBufferLockstep();
+    checkTripleBufferNeverGoesBack();
+    return checkResult("QueueTest");
+}
@@ -0,0 +1,194 @@
+// Checks replay files: that what save writes, load reads back; that bad
+// files are refused; and that a replay's events and state hashes play
+// back on the ticks they were recorded on.
+//
+//     make test
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Check.h"
+#include "Config.h"
+#include "Replay.h"
+
+namespace {
+
+// Scratch files, in the working directory (the build tree under ctest)
+const char* const REPLAY_PATH = "subway_replay_test.replay";
+const char* const BAD_PATH = "subway_replay_bad.replay";
+
+const Uint32 GAME_TICKS = 300;
+
+void writeFile(const std::string& path, const char* text) {
+    std::ofstream file(path.c_str());
+    file << text;
+}
+
+InputEvent keyAt(Uint32 timestamp, char key) {
+    InputEvent e;
+    e.timestamp = timestamp;
+    e.type = INPUT_KEY;
+    e.key = key;
+    e.x = 0;
+    e.y = 0;
+    return e;
+}
+
+void checkRoundTrip() {
+    // Ticks end every 10 ms; each event goes to the tick it arrived in
+    InputQueue live, game;
+    live.push(keyAt(3, 'a'));
+    live.push(keyAt(25, 'w'));
+    live.push(keyAt(30, 'd'));
+    live.push(keyAt(95, 'd'));
+
+    Replay recorded;
+    recorded.seed = 42;
+    for (Uint32 tick = 0; tick < 12; tick++) {
+        recorded.record(live, game, tick, (tick + 1) * 10);
+    }
+    CHECK(live.empty());
+    CHECK_EQ(recorded.length, 12);
+    CHECK_EQ(recorded.events.size(), 4);
+    const Uint32 TICKS[] = {0, 2, 2, 9};
+    InputEvent e;
+    for (size_t i = 0; i < recorded.events.size(); i++) {
+        CHECK_EQ(recorded.events[i].tick, TICKS[i]);
+        CHECK(game.pop(e));
+    }
+
+    CHECK(recorded.save(REPLAY_PATH));
+    Replay loaded;
+    CHECK(loaded.load(REPLAY_PATH));
+    CHECK_EQ(loaded.seed, 42);
+    CHECK_EQ(loaded.length, 12);
+    CHECK_EQ(loaded.events.size(), recorded.events.size());
+    for (size_t i = 0; i < loaded.events.size() && i < recorded.events.size(); i++) {
+        CHECK_EQ(loaded.events[i].tick, recorded.events[i].tick);
+        CHECK_EQ(loaded.events[i].event.type, recorded.events[i].event.type);
+        CHECK_EQ(loaded.events[i].event.key, recorded.events[i].event.key);
+    }
+
+    // Played back, each event lands on its tick, stamped with its end
+    for (Uint32 tick = 0; tick < 12; tick++) {
+        loaded.play(game, tick, 1000 + tick);
+        while (game.pop(e)) {
+            bool due = false;
+            for (size_t i = 0; i < 4; i++) {
+                if (TICKS[i] == tick && recorded.events[i].event.key == e.key) due = true;
+            }
+            CHECK(due);
+            CHECK_EQ(e.timestamp, 1000 + tick);
+        }
+    }
+
+    std::remove(REPLAY_PATH);
+}
+
+// description: runs a game for GAME_TICKS ticks on the replay's events,
+//              checking every tick against its hashes
+// return: void
+// precondition: replay rewound (freshly loaded, or recording)
+// postcondition: state left as after the last tick
+void runGame(Replay& replay, GameState& state, const GameConfig& config) {
+    InputQueue queue;
+    state.reset(config, replay.seed);
+    state.applyKey(config, ' ');
+    for (Uint32 tick = 0; tick < GAME_TICKS; tick++) {
+        replay.play(queue, tick, tick);
+        InputEvent e;
+        while (queue.pop(e)) {
+            state.applyKey(config, e.key);
+        }
+        state.step(config);
+        replay.checkTick(tick, state);
+    }
+}
+
+ReplayEvent recordedKey(Uint32 tick, char key) {
+    ReplayEvent e;
+    e.tick = tick;
+    e.event = keyAt(0, key);
+    return e;
+}
+
+void checkHashes() {
+    GameConfig config;
+    Replay recorded;
+    recorded.seed = 42;
+    recorded.length = GAME_TICKS;
+    recorded.events.push_back(recordedKey(5, 'a'));
+    recorded.events.push_back(recordedKey(40, 'w'));
+    recorded.events.push_back(recordedKey(40, 'd'));
+    recorded.events.push_back(recordedKey(120, 'd'));
+    recorded.recordHashes = true;
+    GameState state;
+    runGame(recorded, state, config);
+    CHECK_EQ(recorded.hashes.size(), GAME_TICKS);
+
+    CHECK(recorded.save(REPLAY_PATH));
+    Replay loaded;
+    CHECK(loaded.load(REPLAY_PATH));
+    CHECK_EQ(loaded.hashes.size(), recorded.hashes.size());
+    for (size_t i = 0; i < loaded.hashes.size() && i < recorded.hashes.size(); i++) {
+        CHECK_EQ(loaded.hashes[i].tick, recorded.hashes[i].tick);
+        CHECK(loaded.hashes[i].hash == recorded.hashes[i].hash);
+    }
+
+    // Played back, every state matches
+    GameState replayed;
+    runGame(loaded, replayed, config);
+    CHECK(replayed.hash() == state.hash());
+    CHECK(loaded.reportCheck(REPLAY_PATH));
+
+    // Dropping an event makes it diverge
+    Replay altered;
+    CHECK(altered.load(REPLAY_PATH));
+    altered.events.erase(altered.events.begin() + 1);
+    runGame(altered, replayed, config);
+    CHECK(!altered.reportCheck(REPLAY_PATH));
+
+    std::remove(REPLAY_PATH);
+}
+
+void checkBadFiles() {
+    Replay replay;
+
+    writeFile(BAD_PATH, "replay 4\nseed 1\nlength 10\nevent 3 0 97 0 0\n");
+    CHECK(replay.load(BAD_PATH));
+    CHECK_EQ(replay.events.size(), 1);
+
+    writeFile(BAD_PATH, "replay 3\nseed 1\nlength 10\n");
+    CHECK(!replay.load(BAD_PATH));
+
+    writeFile(BAD_PATH, "seed 1\nlength 10\n");
+    CHECK(!replay.load(BAD_PATH));
+
+    writeFile(BAD_PATH, "replay 4\nseed 1\nlength 10\nevent 3 0\n");
+    CHECK(!replay.load(BAD_PATH));
+
+    writeFile(BAD_PATH, "replay 4\nseed 1\nevent 5 0 97 0 0\nevent 3 0 97 0 0\n");
+    CHECK(!replay.load(BAD_PATH));
+
+    writeFile(BAD_PATH, "replay 4\nseed 1\nhash 3 1 2 3\n");
+    CHECK(!replay.load(BAD_PATH));
+
+    writeFile(BAD_PATH, "replay 4\nphysics double\n");
+    CHECK(!replay.load(BAD_PATH));
+
+    writeFile(BAD_PATH, "replay 4\nspeed 3\n");
+    CHECK(!replay.load(BAD_PATH));
+
+    std::remove(BAD_PATH);
+    CHECK(!replay.load(BAD_PATH));
+}
+
+}  // namespace
+
+int main() {
+    checkRoundTrip();
+    checkHashes();
+    checkBadFiles();
+    return checkResult("ReplayTest");
+}
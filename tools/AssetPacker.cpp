@@ -0,0 +1,104 @@
+// Packs asset files into a single archive that the game memory-maps at
+// startup (layout in src/AssetFormat.h).
+//
+//     AssetPacker <output.pak> <asset root> <file>...
+//
+// Each file is stored under its path relative to the asset root, e.g.
+// "assets/sfx/coin.wav" with root "assets" becomes "sfx/coin.wav".
+
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "AssetFormat.h"
+
+struct PackedFile {
+    std::string name;
+    std::vector<char> bytes;
+};
+
+static bool byName(const PackedFile& a, const PackedFile& b) {
+    return a.name < b.name;
+}
+
+static uint32_t alignUp(uint32_t value) {
+    return (value + PAK_ALIGNMENT - 1) / PAK_ALIGNMENT * PAK_ALIGNMENT;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <output.pak> <asset root> <file>..." << std::endl;
+        return 1;
+    }
+
+    std::string root = argv[2];
+    if (!root.empty() && root[root.size() - 1] != '/') root += '/';
+
+    std::vector<PackedFile> files;
+    for (int i = 3; i < argc; i++) {
+        PackedFile file;
+        file.name = argv[i];
+        if (file.name.compare(0, root.size(), root) == 0) {
+            file.name.erase(0, root.size());
+        }
+        if (file.name.size() >= (size_t)PAK_NAME_LENGTH) {
+            std::cerr << argv[i] << ": name longer than " << PAK_NAME_LENGTH - 1 << " characters" << std::endl;
+            return 1;
+        }
+
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            std::cerr << argv[i] << ": cannot open" << std::endl;
+            return 1;
+        }
+        file.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        files.push_back(file);
+    }
+    std::sort(files.begin(), files.end(), byName);
+    for (size_t i = 1; i < files.size(); i++) {
+        if (files[i].name == files[i - 1].name) {
+            std::cerr << files[i].name << ": listed twice" << std::endl;
+            return 1;
+        }
+    }
+
+    PakHeader header;
+    memcpy(header.magic, PAK_MAGIC, sizeof(PAK_MAGIC));
+    header.version = PAK_VERSION;
+    header.count = (uint32_t)files.size();
+    header.reserved = 0;
+
+    std::vector<PakEntry> index(files.size());
+    uint32_t offset = alignUp((uint32_t)(sizeof(PakHeader) + files.size() * sizeof(PakEntry)));
+    for (size_t i = 0; i < files.size(); i++) {
+        memset(index[i].name, 0, PAK_NAME_LENGTH);
+        memcpy(index[i].name, files[i].name.c_str(), files[i].name.size());
+        index[i].offset = offset;
+        index[i].size = (uint32_t)files[i].bytes.size();
+        offset = alignUp(offset + index[i].size);
+    }
+
+    std::ofstream out(argv[1], std::ios::binary);
+    if (!out) {
+        std::cerr << argv[1] << ": cannot write" << std::endl;
+        return 1;
+    }
+    out.write((const char*)&header, sizeof(header));
+    if (!index.empty()) {
+        out.write((const char*)&index[0], index.size() * sizeof(PakEntry));
+    }
+    for (size_t i = 0; i < files.size(); i++) {
+        std::vector<char> padding(index[i].offset - (uint32_t)out.tellp(), 0);
+        if (!padding.empty()) out.write(&padding[0], padding.size());
+        if (!files[i].bytes.empty()) out.write(&files[i].bytes[0], files[i].bytes.size());
+    }
+
+    std::cout << "Packed " << files.size() << " assets into " << argv[1] << " (" << out.tellp() << " bytes)"
+              << std::endl;
+    return out ? 0 : 1;
+}